@@ -0,0 +1,144 @@
+#ifndef _ALLOCATION_TRACKING_
+#define _ALLOCATION_TRACKING_
+
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+/**
+ * @brief tracking policies of the allocators:
+ * - Tracked   - every live pointer is remembered, deallocating a pointer that isn't allocated throws
+ *               and is_allocated can be asked
+ * - CountOnly - only the number of live objects is kept for size()
+ * - Untracked - nothing is kept
+ */
+struct Tracked { };
+struct CountOnly { };
+struct Untracked { };
+
+/**
+ * @brief release builds keep only a counter, debug builds validate every deallocation
+ */
+#ifdef NDEBUG
+using DefaultTracking = CountOnly;
+#else
+using DefaultTracking = Tracked;
+#endif
+
+template <class Type, class TrackingPolicy>
+class AllocationRegistry;
+
+template <class Type>
+class AllocationRegistry<Type, Tracked>{
+private:
+    std::unordered_set<Type*> allocated;
+
+public:
+    AllocationRegistry() = default;
+
+    AllocationRegistry(AllocationRegistry<Type, Tracked>&& other) noexcept
+        : allocated(std::move(other.allocated))
+    {
+        other.allocated.clear();
+    }
+
+    AllocationRegistry& operator=(AllocationRegistry<Type, Tracked>&& other) noexcept
+    {
+        allocated = std::move(other.allocated);
+        other.allocated.clear();
+
+        return *this;
+    }
+
+    void add(Type* ptr)
+    {
+        allocated.insert(ptr);
+    }
+
+    void remove(Type* ptr)
+    {
+        if(allocated.erase(ptr) == 0)
+            throw std::invalid_argument("ptr is not allocated");
+    }
+
+    void merge(AllocationRegistry<Type, Tracked>&& other)
+    {
+        allocated.merge(other.allocated);
+        other.allocated.clear();
+    }
+
+    void clear()
+    {
+        allocated.clear();
+    }
+
+    bool contains(Type* ptr) const
+    {
+        return allocated.find(ptr) != allocated.end();
+    }
+
+    size_t size() const
+    {
+        return allocated.size();
+    }
+};
+
+template <class Type>
+class AllocationRegistry<Type, CountOnly>{
+private:
+    size_t allocated = 0;
+
+public:
+    AllocationRegistry() = default;
+
+    AllocationRegistry(AllocationRegistry<Type, CountOnly>&& other) noexcept
+        : allocated(std::exchange(other.allocated, 0))
+    { }
+
+    AllocationRegistry& operator=(AllocationRegistry<Type, CountOnly>&& other) noexcept
+    {
+        allocated = std::exchange(other.allocated, 0);
+
+        return *this;
+    }
+
+    void add(Type*)
+    {
+        ++allocated;
+    }
+
+    void remove(Type*)
+    {
+        --allocated;
+    }
+
+    void merge(AllocationRegistry<Type, CountOnly>&& other)
+    {
+        allocated += std::exchange(other.allocated, 0);
+    }
+
+    void clear()
+    {
+        allocated = 0;
+    }
+
+    size_t size() const
+    {
+        return allocated;
+    }
+};
+
+template <class Type>
+class AllocationRegistry<Type, Untracked>{
+public:
+    void add(Type*) { }
+
+    void remove(Type*) { }
+
+    void merge(AllocationRegistry<Type, Untracked>&&) { }
+
+    void clear() { }
+};
+
+#endif
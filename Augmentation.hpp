@@ -0,0 +1,73 @@
+#ifndef _RBTREE_AUGMENTATION_
+#define _RBTREE_AUGMENTATION_
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief augmentation policies for AugmentedNode - the summary of a subtree is the sum, the minimum
+ *  or the maximum of a payload taken from every element by Projection (the element itself by default)
+ */
+template <class Type, class Projection = std::identity>
+struct SumAugmentation{
+    using summary_type = std::remove_cvref_t<std::invoke_result_t<Projection, const Type&>>;
+
+    static summary_type identity()
+    {
+        return summary_type();
+    }
+
+    static summary_type lift(const Type& value)
+    {
+        return Projection()(value);
+    }
+
+    static summary_type combine(const summary_type& lhs, const summary_type& rhs)
+    {
+        return lhs + rhs;
+    }
+};
+
+template <class Type, class Projection = std::identity>
+struct MinAugmentation{
+    using summary_type = std::remove_cvref_t<std::invoke_result_t<Projection, const Type&>>;
+
+    static summary_type identity()
+    {
+        return std::numeric_limits<summary_type>::max();
+    }
+
+    static summary_type lift(const Type& value)
+    {
+        return Projection()(value);
+    }
+
+    static summary_type combine(const summary_type& lhs, const summary_type& rhs)
+    {
+        return std::min(lhs, rhs);
+    }
+};
+
+template <class Type, class Projection = std::identity>
+struct MaxAugmentation{
+    using summary_type = std::remove_cvref_t<std::invoke_result_t<Projection, const Type&>>;
+
+    static summary_type identity()
+    {
+        return std::numeric_limits<summary_type>::lowest();
+    }
+
+    static summary_type lift(const Type& value)
+    {
+        return Projection()(value);
+    }
+
+    static summary_type combine(const summary_type& lhs, const summary_type& rhs)
+    {
+        return std::max(lhs, rhs);
+    }
+};
+
+#endif
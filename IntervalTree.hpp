@@ -0,0 +1,113 @@
+#ifndef _INTERVAL_TREE_
+#define _INTERVAL_TREE_
+
+#include "RBTree.hpp"
+
+#include <compare>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief a half-open interval [start, end), intervals are ordered by their start and then by their end
+ */
+template <class Type>
+struct Interval{
+    Type start;
+    Type end;
+
+    auto operator<=>(const Interval<Type>& other) const = default;
+
+    bool overlaps(const Interval<Type>& other) const
+    {
+        return start < other.end && other.start < end;
+    }
+};
+
+struct IntervalEnd{
+    template <class Type>
+    const Type& operator()(const Interval<Type>& interval) const
+    {
+        return interval.end;
+    }
+};
+
+/**
+ * @brief the node of an interval tree keeps the largest end in its subtree
+ */
+template <class Type>
+using IntervalNode = AugmentedNode<Interval<Type>, MaxAugmentation<Interval<Type>, IntervalEnd>>;
+
+/**
+ * @brief a red-black tree of intervals keyed on their start, every node keeps the max end of its subtree,
+ *  which is maintained by the rotations and the insert/erase paths like any other augmentation
+ * - a subtree whose max end is not after the start of the query can't contain an overlapping interval
+ * - the intervals in the right subtree of a node that starts at or after the end of the query can't overlap it
+ */
+template <class Type, class Allocator = MyAllocator<IntervalNode<Type>>>
+class IntervalTree : public RBTree<Interval<Type>, Allocator>{
+private:
+    using node_ptr = node_t<Interval<Type>, Allocator>*;
+
+    static_assert(std::is_same_v<node_t<Interval<Type>, Allocator>, IntervalNode<Type>>, 
+                  "The nodes of an interval tree have to be IntervalNodes");
+
+protected:
+    using RBTreeMemoryManager<Interval<Type>, Allocator> :: null_node;
+    using RBTreeMemoryManager<Interval<Type>, Allocator> :: root;
+
+private:
+    template <class Function>
+    void all_overlaps_helper(node_ptr node, const Interval<Type>& interval, Function& function) const
+    {
+        if(node == null_node || !(interval.start < node->summary))
+            return;
+
+        all_overlaps_helper(node->left, interval, function);
+
+        if(!(node->value.start < interval.end))
+            return;
+
+        if(interval.start < node->value.end)
+            function(node->value);
+
+        all_overlaps_helper(node->right, interval, function);
+    }
+
+public:
+    using RBTree<Interval<Type>, Allocator> :: RBTree;
+
+    /**
+     * @brief returns whether an interval in the tree overlaps the given one in O(log n)
+     * - if the left subtree has an end after the start of the query, either it contains an overlapping interval
+     *   or no interval in the tree overlaps, otherwise only the right subtree can contain one
+     */
+    bool any_overlap(const Interval<Type>& interval) const
+    {
+        node_ptr iter = root;
+
+        while(iter != null_node && !iter->value.overlaps(interval))
+        {
+            if(iter->left != null_node && interval.start < iter->left->summary)
+                iter = iter->left;
+            else
+                iter = iter->right;
+        }
+
+        return iter != null_node;
+    }
+
+    /**
+     * @brief calls the function with every interval that overlaps the given one, in order,
+     *  in O(min(n, (k + 1) log n)) for k overlapping intervals
+     * - a subtree is skipped if all its intervals end by the start of the query, and the right subtree of a node
+     *   that starts at or after the end of the query is skipped, so every overlapping interval costs at most a path
+     *   of O(log n) nodes - the walk isn't output sensitive like O(log n + k)
+     */
+    template <class Function>
+    void all_overlaps(const Interval<Type>& interval, Function&& function) const
+    {
+        all_overlaps_helper(root, interval, function);
+    }
+};
+
+#endif
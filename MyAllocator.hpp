@@ -1,23 +1,37 @@
 #ifndef _ALLOCATOR_
 #define _ALLOCATOR_
 
-#include <unordered_set>
+#include <concepts>
+#include <utility>
 
-template <class Type>
+#include "AllocationTracking.hpp"
+
+/**
+ * @brief allocates every object with new
+ * - TrackingPolicy decides what is remembered about the live objects (see AllocationTracking.hpp),
+ *   is_allocated is available only for Tracked and size() - for Tracked and CountOnly
+ */
+template <class Type, class TrackingPolicy = DefaultTracking>
 class MyAllocator{
 private:
-    std::unordered_set<Type*> allocated;
+    AllocationRegistry<Type, TrackingPolicy> allocated;
 
 public:
 
     MyAllocator() = default;
-    MyAllocator(const MyAllocator<Type>& other) = delete;
-    MyAllocator& operator=(const MyAllocator<Type>& other) = delete;
+    MyAllocator(const MyAllocator<Type, TrackingPolicy>& other) = delete;
+    MyAllocator& operator=(const MyAllocator<Type, TrackingPolicy>& other) = delete;
+
+    /**
+     * @brief the moved-from allocator is left empty, the objects it allocated are deallocated by the new one
+     */
+    MyAllocator(MyAllocator<Type, TrackingPolicy>&& other) noexcept = default;
+    MyAllocator& operator=(MyAllocator<Type, TrackingPolicy>&& other) noexcept = default;
 
     Type* allocate()
     {
         Type* temp = new Type();
-        allocated.insert(temp);
+        allocated.add(temp);
 
         return temp;
     }
@@ -31,29 +45,52 @@ public:
     Type* allocate(Args&&... args)
     {
         Type* temp = new Type(std::forward<Args>(args)...);
-        allocated.insert(temp);
+        allocated.add(temp);
 
         return temp;
     }
 
     void deallocate(Type* ptr)
     {
-        if(allocated.count(ptr) == 0)
-            throw std::invalid_argument("ptr is not allocated");
-
-        allocated.erase(ptr);
+        allocated.remove(ptr);
         delete ptr;
     }
 
+    /**
+     * @brief the allocator stops owning the object without deallocating it, 
+     *  it has to be adopted by another MyAllocator of the same type
+     */
+    void release(Type* ptr)
+    {
+        allocated.remove(ptr);
+    }
+
+    void adopt(Type* ptr)
+    {
+        allocated.add(ptr);
+    }
+
+    /**
+     * @brief takes all objects of the other allocator, which is left empty
+     */
+    void merge(MyAllocator<Type, TrackingPolicy>&& other)
+    {
+        allocated.merge(std::move(other.allocated));
+    }
+
     bool is_allocated(Type* ptr) const
     {
-        return allocated.find(ptr) != allocated.end();
+        return allocated.contains(ptr);
     }
 
+    /**
+     * @brief the number of live objects, O(1) - allocators that don't track their objects have no size
+     */
     size_t size() const
+        requires (!std::same_as<TrackingPolicy, Untracked>)
     {
         return allocated.size();
     }
 };
 
-#endif
\ No newline at end of file
+#endif
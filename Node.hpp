@@ -1,6 +1,11 @@
 #ifndef _RBTREE_NODE_
 #define _RBTREE_NODE_
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
 enum class NodeColor : bool {Black, Red}; 
 
 template <class Type>
@@ -28,6 +33,18 @@ public:
         , color(NodeColor :: Red)
     { }
 
+    /**
+     * @brief constructs the value in place from the given arguments
+     */
+    template <class... Args>
+    Node(std::in_place_t, node_ptr parent, node_ptr null_node, Args&&... args)
+        : value(std::forward<Args>(args)...)
+        , parent(parent)
+        , left(null_node)
+        , right(null_node)
+        , color(NodeColor :: Red)
+    { }
+
     Node(const node_ptr& other) 
         : value(other->value)
         , left(nullptr)
@@ -35,6 +52,240 @@ public:
         , color(other->color)
     { }
 
+    node_ptr get_parent() const
+    {
+        return parent;
+    }
+
+    void set_parent(node_ptr node)
+    {
+        parent = node;
+    }
+
+    NodeColor get_color() const
+    {
+        return color;
+    }
+
+    void set_color(NodeColor new_color)
+    {
+        color = new_color;
+    }
+
+    /**
+     * @brief if parent exists returns whether the node is left child otherwise return false
+     */
+    bool is_left_child() const
+    {
+        return parent ? this == parent->left : false;
+    }
+
+    bool is_black() const
+    {
+        return color == NodeColor :: Black;
+    }
+
+    bool is_red() const
+    {
+        return !is_black();
+    }
+
+    void make_black()
+    {
+        color = NodeColor :: Black;
+    }
+
+    void make_red()
+    {
+        color = NodeColor :: Red;
+    }
+};
+
+/**
+ * @brief a node with the same interface as Node that keeps its color in the lowest bit of the parent pointer
+ * - nodes are at least 2-byte aligned, so that bit of a node address is always zero
+ * - a CompactNode<int> takes 32 bytes instead of 40, so two nodes fit in a cache line
+ * - the parent and the color are accessible only through get_parent/set_parent and get_color/set_color
+ */
+template <class Type>
+struct CompactNode{
+public:
+    using node_ptr = CompactNode<Type>*;
+
+    Type  value;
+    CompactNode *left, *right;
+
+private:
+    static constexpr std::uintptr_t red_bit = 1;
+
+    std::uintptr_t parent_and_color;
+
+public:
+    CompactNode()
+        : left(nullptr)
+        , right(nullptr)
+        , parent_and_color(0)
+    { }
+
+    CompactNode(const Type& value, node_ptr parent, node_ptr null_node)
+        : value(value)
+        , left(null_node)
+        , right(null_node)
+        , parent_and_color(reinterpret_cast<std::uintptr_t>(parent) | red_bit)
+    { }
+
+    /**
+     * @brief constructs the value in place from the given arguments
+     */
+    template <class... Args>
+    CompactNode(std::in_place_t, node_ptr parent, node_ptr null_node, Args&&... args)
+        : value(std::forward<Args>(args)...)
+        , left(null_node)
+        , right(null_node)
+        , parent_and_color(reinterpret_cast<std::uintptr_t>(parent) | red_bit)
+    { }
+
+    CompactNode(const node_ptr& other)
+        : value(other->value)
+        , left(nullptr)
+        , right(nullptr)
+        , parent_and_color(other->parent_and_color & red_bit)
+    { }
+
+    node_ptr get_parent() const
+    {
+        return reinterpret_cast<node_ptr>(parent_and_color & ~red_bit);
+    }
+
+    void set_parent(node_ptr node)
+    {
+        parent_and_color = reinterpret_cast<std::uintptr_t>(node) | (parent_and_color & red_bit);
+    }
+
+    NodeColor get_color() const
+    {
+        return (parent_and_color & red_bit) ? NodeColor :: Red : NodeColor :: Black;
+    }
+
+    void set_color(NodeColor new_color)
+    {
+        parent_and_color = (parent_and_color & ~red_bit) | (new_color == NodeColor :: Red ? red_bit : 0);
+    }
+
+    /**
+     * @brief if parent exists returns whether the node is left child otherwise return false
+     */
+    bool is_left_child() const
+    {
+        node_ptr parent = get_parent();
+
+        return parent ? this == parent->left : false;
+    }
+
+    bool is_black() const
+    {
+        return !is_red();
+    }
+
+    bool is_red() const
+    {
+        return parent_and_color & red_bit;
+    }
+
+    void make_black()
+    {
+        parent_and_color &= ~red_bit;
+    }
+
+    void make_red()
+    {
+        parent_and_color |= red_bit;
+    }
+};
+
+/**
+ * @brief a node that also keeps the number of elements in its subtree, it enables the order statistics
+ *  of the tree (select, rank, count_range and size in O(1))
+ * - the size of the null node is 0, so recompute() doesn't have to check for missing children
+ * - the size is recomputed by the tree after every change of the children of the node
+ */
+template <class Type>
+struct SizedNode{ 
+public:
+    using node_ptr = SizedNode<Type>*;
+
+    Type  value;
+    SizedNode *parent;
+    SizedNode *left, *right;
+    size_t size;
+    NodeColor color;
+
+public:
+    SizedNode()
+        : left(nullptr)
+        , right(nullptr)
+        , size(0)
+        , color(NodeColor :: Black) 
+    { }
+
+    SizedNode(const Type& value, node_ptr parent, node_ptr null_node) 
+        : value(value)
+        , parent(parent)
+        , left(null_node)
+        , right(null_node)
+        , size(1)
+        , color(NodeColor :: Red)
+    { }
+
+    /**
+     * @brief constructs the value in place from the given arguments
+     */
+    template <class... Args>
+    SizedNode(std::in_place_t, node_ptr parent, node_ptr null_node, Args&&... args)
+        : value(std::forward<Args>(args)...)
+        , parent(parent)
+        , left(null_node)
+        , right(null_node)
+        , size(1)
+        , color(NodeColor :: Red)
+    { }
+
+    SizedNode(const node_ptr& other) 
+        : value(other->value)
+        , left(nullptr)
+        , right(nullptr)
+        , size(other->size)
+        , color(other->color)
+    { }
+
+    /**
+     * @brief sets the size from the sizes of the children
+     */
+    void recompute()
+    {
+        size = left->size + right->size + 1;
+    }
+
+    node_ptr get_parent() const
+    {
+        return parent;
+    }
+
+    void set_parent(node_ptr node)
+    {
+        parent = node;
+    }
+
+    NodeColor get_color() const
+    {
+        return color;
+    }
+
+    void set_color(NodeColor new_color)
+    {
+        color = new_color;
+    }
+
     /**
      * @brief if parent exists returns whether the node is left child otherwise return false
      */
@@ -64,4 +315,167 @@ public:
     }
 };
 
+/**
+ * @brief a node that keeps a summary of its subtree defined by an augmentation policy - a monoid over the elements:
+ * - summary_type - the type of the summary
+ * - identity() - the summary of an empty subtree, it is the summary of the null node
+ * - lift(value) - the summary of a single element
+ * - combine(lhs, rhs) - the summary of two neighbouring ranges, it has to be associative
+ * - the summary is recomputed by the tree after every change of the children of the node
+ */
+template <class Type, class Augmentation>
+struct AugmentedNode{ 
+public:
+    using node_ptr = AugmentedNode<Type, Augmentation>*;
+    using augmentation = Augmentation;
+    using summary_type = typename Augmentation :: summary_type;
+
+    Type  value;
+    AugmentedNode *parent;
+    AugmentedNode *left, *right;
+    summary_type summary;
+    NodeColor color;
+
+public:
+    AugmentedNode()
+        : left(nullptr)
+        , right(nullptr)
+        , summary(Augmentation :: identity())
+        , color(NodeColor :: Black) 
+    { }
+
+    AugmentedNode(const Type& value, node_ptr parent, node_ptr null_node) 
+        : value(value)
+        , parent(parent)
+        , left(null_node)
+        , right(null_node)
+        , summary(Augmentation :: lift(this->value))
+        , color(NodeColor :: Red)
+    { }
+
+    /**
+     * @brief constructs the value in place from the given arguments
+     */
+    template <class... Args>
+    AugmentedNode(std::in_place_t, node_ptr parent, node_ptr null_node, Args&&... args)
+        : value(std::forward<Args>(args)...)
+        , parent(parent)
+        , left(null_node)
+        , right(null_node)
+        , summary(Augmentation :: lift(this->value))
+        , color(NodeColor :: Red)
+    { }
+
+    AugmentedNode(const node_ptr& other) 
+        : value(other->value)
+        , left(nullptr)
+        , right(nullptr)
+        , summary(other->summary)
+        , color(other->color)
+    { }
+
+    /**
+     * @brief sets the summary from the summaries of the children and the element, in order
+     */
+    void recompute()
+    {
+        summary = Augmentation :: combine(Augmentation :: combine(left->summary, Augmentation :: lift(value)), 
+                                          right->summary);
+    }
+
+    node_ptr get_parent() const
+    {
+        return parent;
+    }
+
+    void set_parent(node_ptr node)
+    {
+        parent = node;
+    }
+
+    NodeColor get_color() const
+    {
+        return color;
+    }
+
+    void set_color(NodeColor new_color)
+    {
+        color = new_color;
+    }
+
+    /**
+     * @brief if parent exists returns whether the node is left child otherwise return false
+     */
+    bool is_left_child() const
+    {
+        return parent ? this == parent->left : false;
+    }
+
+    bool is_black() const
+    {
+        return color == NodeColor :: Black;
+    }
+
+    bool is_red() const
+    {
+        return !is_black();
+    }
+
+    void make_black()
+    {
+        color = NodeColor :: Black;
+    }
+
+    void make_red()
+    {
+        color = NodeColor :: Red;
+    }
+};
+
+/**
+ * @brief the node types that a tree can be built of
+ */
+template <class NodeType>
+struct is_node : std::false_type { };
+
+template <class Type>
+struct is_node<Node<Type>> : std::true_type { };
+
+template <class Type>
+struct is_node<CompactNode<Type>> : std::true_type { };
+
+template <class Type>
+struct is_node<SizedNode<Type>> : std::true_type { };
+
+template <class Type, class Augmentation>
+struct is_node<AugmentedNode<Type, Augmentation>> : std::true_type { };
+
+/**
+ * @brief augmented nodes keep a summary of their subtree that has to be recomputed
+ *  after the children of the node change, plain nodes don't pay anything for it
+ */
+template <class NodeType, class = void>
+struct is_augmented_node : std::false_type { };
+
+template <class NodeType>
+struct is_augmented_node<NodeType, std::void_t<decltype(std::declval<NodeType&>().recompute())>> : std::true_type { };
+
+/**
+ * @brief nodes that know the size of their subtree
+ */
+template <class NodeType, class = void>
+struct has_subtree_size : std::false_type { };
+
+template <class NodeType>
+struct has_subtree_size<NodeType, std::void_t<decltype(std::declval<NodeType&>().size)>> : std::true_type { };
+
+/**
+ * @brief nodes that keep a summary of their subtree defined by an augmentation policy
+ */
+template <class NodeType, class = void>
+struct has_subtree_summary : std::false_type { };
+
+template <class NodeType>
+struct has_subtree_summary<NodeType, std::void_t<typename NodeType::augmentation>> : std::true_type { };
+
 #endif
\ No newline at end of file
@@ -0,0 +1,274 @@
+#ifndef _NODE_ALLOCATOR_TRAITS_
+#define _NODE_ALLOCATOR_TRAITS_
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Node.hpp"
+
+/**
+ * @brief adapts a standard allocator (std::allocator, std::pmr::polymorphic_allocator, ...)
+ *  to the allocate(args...) / deallocate / size() interface used by the tree
+ * - the allocator is rebound to Type through std::allocator_traits
+ * - a copy of the adaptor is an empty adaptor with the allocator
+ *   chosen by select_on_container_copy_construction
+ */
+template <class Type, class Allocator>
+class StdAllocatorAdaptor{
+public:
+    using allocator_type = typename std::allocator_traits<Allocator> :: template rebind_alloc<Type>;
+
+private:
+    using traits = std::allocator_traits<allocator_type>;
+
+    allocator_type alloc;
+    size_t allocated;
+
+public:
+    StdAllocatorAdaptor()
+        : alloc()
+        , allocated(0)
+    { }
+
+    explicit StdAllocatorAdaptor(const Allocator& allocator)
+        : alloc(allocator)
+        , allocated(0)
+    { }
+
+    StdAllocatorAdaptor(const StdAllocatorAdaptor<Type, Allocator>& other)
+        : alloc(traits::select_on_container_copy_construction(other.alloc))
+        , allocated(0)
+    { }
+
+    StdAllocatorAdaptor& operator=(const StdAllocatorAdaptor<Type, Allocator>& other) = delete;
+
+    StdAllocatorAdaptor(StdAllocatorAdaptor<Type, Allocator>&& other) noexcept
+        : alloc(std::move(other.alloc))
+        , allocated(std::exchange(other.allocated, 0))
+    { }
+
+    /**
+     * @brief takes the objects of the other adaptor, the allocator itself is replaced only
+     *  if it propagates on move assignment - otherwise both allocators must compare equal
+     */
+    StdAllocatorAdaptor& operator=(StdAllocatorAdaptor<Type, Allocator>&& other) noexcept
+    {
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+            alloc = std::move(other.alloc);
+
+        allocated = std::exchange(other.allocated, 0);
+
+        return *this;
+    }
+
+    /**
+     * @brief allocates memory for one object and constructs it through the allocator
+     * - the arguments of the constructor are passed using perfect forwarding
+     * - if the constructor throws the memory is given back to the allocator
+     * @param args - the parmeters of the constructor
+     */
+    template <class... Args>
+    Type* allocate(Args&&... args)
+    {
+        Type* temp = std::to_address(traits::allocate(alloc, 1));
+
+        try
+        {
+            traits::construct(alloc, temp, std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            traits::deallocate(alloc, temp, 1);
+            throw;
+        }
+
+        ++allocated;
+
+        return temp;
+    }
+
+    void deallocate(Type* ptr)
+    {
+        traits::destroy(alloc, ptr);
+        traits::deallocate(alloc, ptr, 1);
+        --allocated;
+    }
+
+    /**
+     * @brief the adaptor stops owning the object, it has to be adopted by an adaptor with an equal allocator
+     */
+    void release(Type*)
+    {
+        --allocated;
+    }
+
+    void adopt(Type*)
+    {
+        ++allocated;
+    }
+
+    size_t size() const
+    {
+        return allocated;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return alloc;
+    }
+
+    bool operator==(const StdAllocatorAdaptor<Type, Allocator>& other) const
+    {
+        return alloc == other.alloc;
+    }
+};
+
+/**
+ * @brief standard allocators are recognized by their value_type,
+ *  the allocators of this library (MyAllocator, SlabAllocator) construct objects themselves and don't have one
+ */
+template <class Allocator, class = void>
+struct is_standard_allocator : std::false_type { };
+
+template <class Allocator>
+struct is_standard_allocator<Allocator, std::void_t<typename Allocator::value_type>> : std::true_type { };
+
+/**
+ * @brief allocators with deallocate_all (SlabAllocator) can release all of their objects in one step,
+ *  so the tree doesn't have to visit its nodes when it is cleared or destroyed
+ */
+template <class Allocator, class = void>
+struct has_region_release : std::false_type { };
+
+template <class Allocator>
+struct has_region_release<Allocator, std::void_t<decltype(std::declval<Allocator&>().deallocate_all())>> : std::true_type { };
+
+/**
+ * @brief allocators with reserve (SlabAllocator) can take the memory for many objects in one block,
+ *  which the tree uses when it is built from a sorted range
+ */
+template <class Allocator, class = void>
+struct has_reserve : std::false_type { };
+
+template <class Allocator>
+struct has_reserve<Allocator, std::void_t<decltype(std::declval<Allocator&>().reserve(size_t()))>> : std::true_type { };
+
+/**
+ * @brief allocators that count their live objects (all but the untracked ones) know in O(1) how many nodes
+ *  a tree has allocated, which bounds the memory reserved for a copy of the tree
+ */
+template <class Allocator, class = void>
+struct has_allocation_count : std::false_type { };
+
+template <class Allocator>
+struct has_allocation_count<Allocator, std::void_t<decltype(std::declval<const Allocator&>().size())>> : std::true_type { };
+
+/**
+ * @brief allocators with merge (MyAllocator, SlabAllocator) can take all objects of another allocator at once,
+ *  so nodes can be allocated by many threads with their own allocators and given to the tree afterwards
+ */
+template <class Allocator, class = void>
+struct has_allocator_merge : std::false_type { };
+
+template <class Allocator>
+struct has_allocator_merge<Allocator, std::void_t<decltype(std::declval<Allocator&>().merge(std::declval<Allocator&&>()))>> 
+    : std::true_type { };
+
+/**
+ * @brief allocators with release and adopt (MyAllocator, StdAllocatorAdaptor) can give single objects
+ *  to other allocators, SlabAllocator can't because its objects live in its slabs
+ */
+template <class Allocator, class = void>
+struct has_node_release : std::false_type { };
+
+template <class Allocator>
+struct has_node_release<Allocator, std::void_t<decltype(std::declval<Allocator&>().release(std::declval<Allocator&>().allocate())),
+                                               decltype(std::declval<Allocator&>().adopt(std::declval<Allocator&>().allocate()))>> 
+    : std::true_type { };
+
+/**
+ * @brief how nodes can be moved between allocators
+ * - on_move - whether a move assigned tree can take the nodes of the other tree:
+ *   the allocators of this library are moved together with the nodes,
+ *   standard allocators - if they propagate on move assignment or are always equal, otherwise only if they compare equal
+ * - detached_allocator - an allocator that can own a node given away by the allocator (used by node handles)
+ * - compatible - whether nodes given away by one allocator can be adopted by the other:
+ *   all MyAllocators allocate with new, standard allocators have to compare equal
+ */
+template <class NodeAllocator>
+struct node_transfer_traits{
+    static constexpr bool always_on_move = true;
+
+    static bool on_move(const NodeAllocator&, const NodeAllocator&)
+    {
+        return true;
+    }
+
+    static NodeAllocator detached_allocator(const NodeAllocator&)
+    {
+        return NodeAllocator();
+    }
+
+    static bool compatible(const NodeAllocator&, const NodeAllocator&)
+    {
+        return true;
+    }
+};
+
+template <class Type, class Allocator>
+struct node_transfer_traits<StdAllocatorAdaptor<Type, Allocator>>{
+private:
+    using traits = std::allocator_traits<typename StdAllocatorAdaptor<Type, Allocator> :: allocator_type>;
+
+public:
+    static constexpr bool always_on_move = traits::propagate_on_container_move_assignment::value
+                                        || traits::is_always_equal::value;
+
+    static bool on_move(const StdAllocatorAdaptor<Type, Allocator>& lhs, const StdAllocatorAdaptor<Type, Allocator>& rhs)
+    {
+        return always_on_move || lhs == rhs;
+    }
+
+    static StdAllocatorAdaptor<Type, Allocator> detached_allocator(const StdAllocatorAdaptor<Type, Allocator>& owner)
+    {
+        return StdAllocatorAdaptor<Type, Allocator>(owner.get_allocator());
+    }
+
+    static bool compatible(const StdAllocatorAdaptor<Type, Allocator>& lhs, const StdAllocatorAdaptor<Type, Allocator>& rhs)
+    {
+        return lhs == rhs;
+    }
+};
+
+/**
+ * @brief the node type of the tree is chosen by its allocator:
+ * - the allocators of this library - the type they allocate (MyAllocator<CompactNode<Type>> builds a compact tree)
+ * - standard allocators - their value_type if it is a node type, otherwise Node<Type>
+ */
+template <class Type, class Allocator, bool = is_standard_allocator<Allocator>::value>
+struct node_type_of{
+    using type = std::remove_pointer_t<decltype(std::declval<Allocator&>().allocate())>;
+};
+
+template <class Type, class Allocator>
+struct node_type_of<Type, Allocator, true>{
+    using type = std::conditional_t<is_node<typename Allocator::value_type>::value,
+                                    typename Allocator::value_type,
+                                    Node<Type>>;
+};
+
+template <class Type, class Allocator>
+using node_t = typename node_type_of<Type, Allocator> :: type;
+
+/**
+ * @brief the allocator that the tree uses for its nodes:
+ * - standard allocators are rebound to the node type and wrapped in StdAllocatorAdaptor
+ * - any other allocator is used as it is
+ */
+template <class Type, class Allocator>
+using node_allocator_t = std::conditional_t<is_standard_allocator<Allocator>::value,
+                                            StdAllocatorAdaptor<node_t<Type, Allocator>, Allocator>,
+                                            Allocator>;
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef _RBTREE_NODE_HANDLE_
+#define _RBTREE_NODE_HANDLE_
+
+#include <utility>
+
+#include "NodeAllocatorTraits.hpp"
+
+template <class Type, class Allocator, class Compare>
+class RBTree;
+
+/**
+ * @brief owns a node that has been extracted from a tree, so that it can be inserted in another tree
+ *  without deallocating the node or copying its element
+ * - the node is owned through its own allocator compatible with the allocator of the tree
+ *   (see node_transfer_traits), so the handle can outlive the tree
+ * - if the handle still owns a node when it is destroyed the node is deallocated
+ */
+template <class NodeType, class NodeAllocator>
+class NodeHandle{
+private:
+    template <class, class, class>
+    friend class RBTree;
+
+    using node_ptr = NodeType*;
+
+    node_ptr node;
+    NodeAllocator alloc;
+
+    NodeHandle(node_ptr node, NodeAllocator& owner)
+        : node(node)
+        , alloc(node_transfer_traits<NodeAllocator>::detached_allocator(owner))
+    {
+        static_assert(has_node_release<NodeAllocator>::value, "The allocator can't give away single nodes");
+
+        alloc.adopt(node);
+        owner.release(node);
+    }
+
+    node_ptr release_to(NodeAllocator& owner)
+    {
+        owner.adopt(node);
+        alloc.release(node);
+
+        return std::exchange(node, nullptr);
+    }
+
+public:
+    NodeHandle()
+        : node(nullptr)
+        , alloc()
+    { }
+
+    NodeHandle(const NodeHandle<NodeType, NodeAllocator>& other) = delete;
+    NodeHandle& operator=(const NodeHandle<NodeType, NodeAllocator>& other) = delete;
+
+    NodeHandle(NodeHandle<NodeType, NodeAllocator>&& other) noexcept
+        : node(std::exchange(other.node, nullptr))
+        , alloc(std::move(other.alloc))
+    { }
+
+    /**
+     * @brief the node that the handle still owns is deallocated, then the node and the allocator
+     *  of the other handle are taken
+     */
+    NodeHandle& operator=(NodeHandle<NodeType, NodeAllocator>&& other) noexcept
+    {
+        if(this != &other)
+        {
+            if(node)
+                alloc.deallocate(node);
+
+            node = std::exchange(other.node, nullptr);
+            alloc = std::move(other.alloc);
+        }
+
+        return *this;
+    }
+
+    ~NodeHandle()
+    {
+        if(node)
+            alloc.deallocate(node);
+    }
+
+    bool empty() const
+    {
+        return node == nullptr;
+    }
+
+    explicit operator bool() const
+    {
+        return !empty();
+    }
+
+    /**
+     * @brief the element of the node - it can be changed before the node is inserted again
+     */
+    auto& value() const
+    {
+        return node->value;
+    }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef _PARALLEL_SORT_
+#define _PARALLEL_SORT_
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief runs function(0), ..., function(count - 1) at once, function(0) on the calling thread
+ *  and the others in new threads
+ * - if a thread can't be started its task runs on the calling thread after the others are started
+ * - the first exception thrown by a task is rethrown after all tasks are done
+ */
+template <class Function>
+void run_tasks(size_t count, Function&& function)
+{
+    std::vector<std::future<void>> tasks;
+    std::vector<size_t> not_started;
+    tasks.reserve(count);
+
+    for(size_t i = 1; i < count; ++i)
+    {
+        try
+        {
+            tasks.push_back(std::async(std::launch::async, std::ref(function), i));
+        }
+        catch(const std::system_error&)
+        {
+            not_started.push_back(i);
+        }
+    }
+
+    std::exception_ptr error;
+
+    auto run = [&](size_t i){
+        try
+        {
+            function(i);
+        }
+        catch(...)
+        {
+            if(!error)
+                error = std::current_exception();
+        }
+    };
+
+    run(0);
+
+    for(size_t i : not_started)
+        run(i);
+
+    for(std::future<void>& task : tasks)
+    {
+        try
+        {
+            task.get();
+        }
+        catch(...)
+        {
+            if(!error)
+                error = std::current_exception();
+        }
+    }
+
+    if(error)
+        std::rethrow_exception(error);
+}
+
+/**
+ * @brief elements of integral types ordered by std::less can be sorted by their bits (radix sort)
+ */
+template <class Type, class Compare>
+concept radix_sortable = std::integral<Type> && !std::same_as<Type, bool>
+                      && (std::same_as<Compare, std::less<Type>> || std::same_as<Compare, std::less<>>);
+
+/**
+ * @brief below this number of elements per thread the sorts run on one thread
+ */
+inline constexpr size_t parallel_sort_grain = size_t(1) << 14;
+
+/**
+ * @brief least significant digit radix sort with 8-bit digits
+ * - every thread counts the digits of its part of the elements, the counts give every thread
+ *   its own positions in each bucket, so the elements are scattered by all threads at once without locks
+ * - signed elements are sorted by their bits with the sign bit flipped
+ * - the passes over digits that are equal in all elements are skipped
+ */
+template <std::integral Type>
+void parallel_radix_sort(std::span<Type> values, size_t threads)
+{
+    using Key = std::make_unsigned_t<Type>;
+
+    constexpr size_t digit_bits = 8;
+    constexpr size_t buckets = size_t(1) << digit_bits;
+    constexpr Key flip = std::is_signed_v<Type> ? Key(Key(1) << (sizeof(Type) * 8 - 1)) : Key(0);
+
+    threads = std::clamp<size_t>(values.size() / parallel_sort_grain, 1, std::max<size_t>(threads, 1));
+
+    std::vector<Type> buffer(values.size());
+    std::span<Type> from = values, to = buffer;
+    std::vector<std::array<size_t, buckets>> counts(threads);
+    size_t part = (values.size() + threads - 1) / threads;
+
+    for(size_t shift = 0; shift < sizeof(Type) * 8; shift += digit_bits)
+    {
+        auto digit = [shift](Type value){
+            return size_t((Key(value) ^ flip) >> shift) & (buckets - 1);
+        };
+
+        run_tasks(threads, [&](size_t thread){
+            counts[thread].fill(0);
+
+            for(size_t i = thread * part; i < std::min(values.size(), (thread + 1) * part); ++i)
+                ++counts[thread][digit(from[i])];
+        });
+
+        size_t offset = 0;
+        bool one_bucket = false;
+
+        for(size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+            size_t bucket_start = offset;
+
+            for(size_t thread = 0; thread < threads; ++thread)
+                offset += std::exchange(counts[thread][bucket], offset);
+
+            one_bucket = one_bucket || offset - bucket_start == values.size();
+        }
+
+        if(one_bucket)
+            continue;
+
+        run_tasks(threads, [&](size_t thread){
+            for(size_t i = thread * part; i < std::min(values.size(), (thread + 1) * part); ++i)
+                to[counts[thread][digit(from[i])]++] = from[i];
+        });
+
+        std::swap(from, to);
+    }
+
+    if(from.data() != values.data())
+        std::copy(from.begin(), from.end(), values.begin());
+}
+
+/**
+ * @brief merge sort whose halves are sorted in parallel, the parts below the grain are sorted with std::sort
+ * - the merges of each level run in parallel, the last merge runs on one thread
+ */
+template <class Type, class Less>
+void parallel_merge_sort(std::span<Type> values, const Less& less, size_t threads)
+{
+    if(threads < 2 || values.size() < 2 * parallel_sort_grain)
+    {
+        std::sort(values.begin(), values.end(), less);
+        return;
+    }
+
+    size_t middle = values.size() / 2;
+
+    run_tasks(2, [&](size_t half){
+        if(half == 0)
+            parallel_merge_sort(values.first(middle), less, threads / 2);
+        else
+            parallel_merge_sort(values.subspan(middle), less, threads - threads / 2);
+    });
+
+    std::inplace_merge(values.begin(), values.begin() + middle, values.end(), less);
+}
+
+#endif
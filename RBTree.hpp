@@ -5,51 +5,130 @@
 #include "MyAllocator.hpp"
 #include "RBTreeMemoryManager.hpp"
 #include "RBTreeFixupOperations.hpp"
+#include "RBTreeJoinOperations.hpp"
+#include "NodeHandle.hpp"
+#include "RBTreeIterator.hpp"
+#include "Augmentation.hpp"
+#include "ThreeWayCompare.hpp"
+#include "ParallelSort.hpp"
 
-template <class Type, class Allocator = MyAllocator<Node<Type>>>
-class RBTree : public RBTreeFixupOperations<Type, Allocator>{
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief a red-black tree of unique elements ordered by Compare
+ * - Compare may return bool (like std::less) or an ordering (like std::compare_three_way),
+ *   see ThreeWayCompare for how many times it is called per level
+ */
+template <class Type, class Allocator = MyAllocator<Node<Type>>, class Compare = std::less<Type>>
+class RBTree : public RBTreeJoinOperations<Type, Allocator>{
 private:
-    using node_ptr = Node<Type>*;
+    using node_type = node_t<Type, Allocator>;
+    using node_ptr = node_type*;
+    using node_allocator = typename RBTreeMemoryManager<Type, Allocator> :: node_allocator;
+
+public:
+    using node_handle = NodeHandle<node_t<Type, Allocator>, node_allocator>;
+
+    using const_iterator = RBTreeIterator<node_t<Type, Allocator>>;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
 
 protected:
     using RBTreeMemoryManager<Type, Allocator> :: null_node;
     using RBTreeMemoryManager<Type, Allocator> :: root;
     using RBTreeMemoryManager<Type, Allocator> :: alloc;
 
+    using RBTreeMemoryManager<Type, Allocator> :: delete_tree;
+    using RBTreeMemoryManager<Type, Allocator> :: create_node;
+    using RBTreeMemoryManager<Type, Allocator> :: destroy_node;
     using RBTreeMemoryManager<Type, Allocator> :: delete_not_null_nodes;
+    using RBTreeMemoryManager<Type, Allocator> :: walk_preorder;
+    using RBTreeMemoryManager<Type, Allocator> :: tree_black_height;
     
     using RBTreeFixupOperations<Type, Allocator> :: transplant;
     using RBTreeFixupOperations<Type, Allocator> :: insert_fixup;
     using RBTreeFixupOperations<Type, Allocator> :: delete_fixup;
+    using RBTreeFixupOperations<Type, Allocator> :: update_path;
+    using RBTreeFixupOperations<Type, Allocator> :: update_node;
+
+    using typename RBTreeJoinOperations<Type, Allocator> :: Subtree;
+    using RBTreeJoinOperations<Type, Allocator> :: as_subtree;
+    using RBTreeJoinOperations<Type, Allocator> :: join_subtrees;
+    using RBTreeJoinOperations<Type, Allocator> :: split_subtree;
+    using RBTreeJoinOperations<Type, Allocator> :: union_subtrees;
+    using RBTreeJoinOperations<Type, Allocator> :: intersect_subtrees;
+    using RBTreeJoinOperations<Type, Allocator> :: subtract_subtrees;
 
 private:
-    node_ptr find_node_with_value(const Type& value) const
+    ThreeWayCompare<Type, Compare> compare;
+
+    RBTree(const ThreeWayCompare<Type, Compare>& compare, node_allocator&& allocator)
+        : RBTreeJoinOperations<Type, Allocator>(std::in_place, std::move(allocator))
+        , compare(compare)
+    { }
+
+public:
+    using RBTreeJoinOperations<Type, Allocator> :: RBTreeJoinOperations;
+
+    RBTree() = default;
+
+    explicit RBTree(const Compare& comp)
+        : compare(comp)
+    { }
+
+    RBTree(const Compare& comp, const Allocator& allocator)
+        : RBTreeJoinOperations<Type, Allocator>(allocator)
+        , compare(comp)
+    { }
+
+    /**
+     * @brief exchanges the nodes, the allocators and the comparators of both trees in O(1)
+     */
+    void swap(RBTree<Type, Allocator, Compare>& other) noexcept
     {
-        node_ptr iter = root;
+        RBTreeMemoryManager<Type, Allocator> :: swap(other);
+        std::swap(compare, other.compare);
+    }
 
-        while(iter != null_node && iter->value != value)
-        {
-            if(value < iter->value)
-                iter = iter->left;
-            else
-                iter = iter->right;
-        }
+private:
+    const_iterator make_iterator(node_ptr node) const
+    {
+        return const_iterator(node, null_node, &root);
+    }
 
-        return iter;
+    node_ptr find_node_with_value(const Type& value) const
+    {
+        return find_node_with_value(value, root);
     }
 
-    void calculate_height(node_ptr node, size_t& height, size_t curr_height = 0) const
+    /**
+     * @brief searches for the value in the subtree of start
+     */
+    node_ptr find_node_with_value(const Type& value, node_ptr start) const
     {
-        if(node == null_node)
+        node_ptr iter = start;
+
+        while(iter != null_node)
         {
-            if(curr_height > height)
-                height = curr_height;
+            std::weak_ordering order = compare(value, iter->value);
 
-            return;
+            if(order < 0)
+                iter = iter->left;
+            else if(order > 0)
+                iter = iter->right;
+            else
+                break;
         }
 
-        calculate_height(node->left, height, curr_height + 1);
-        calculate_height(node->right, height, curr_height + 1);
+        return iter;
     }
 
 // delete_node helper functions
@@ -62,160 +141,1364 @@ private:
         return node;         
     }
 
-    void swap_values_of_delete_node_and_successor(node_ptr& delete_node, node_ptr& successor, 
-                                         node_ptr& fixup_node, NodeColor& node_color)
+    /**
+     * @brief puts the successor in the place of the deleted node - the successor takes its children and its color
+     * - if the successor is the right child of the deleted node its right subtree stays in place
+     * - otherwise the successor is first replaced with its right subtree 
+     *   and takes the right subtree of the deleted node
+     */
+    void replace_with_successor(node_ptr& delete_node, node_ptr& successor, 
+                                node_ptr& fixup_node, NodeColor& node_color)
     {
-        std::swap(successor->value, delete_node->value);
         fixup_node = successor->right;
-        node_color = successor->color;
+        node_color = successor->get_color();
+
+        if(successor->get_parent() == delete_node)
+            fixup_node->set_parent(successor);
+        else
+        {
+            transplant(successor, successor->right);
+            successor->right = delete_node->right;
+            successor->right->set_parent(successor);
+        }
+
+        transplant(delete_node, successor);
+        successor->left = delete_node->left;
+        successor->left->set_parent(successor);
+        successor->set_color(delete_node->get_color());
     }
 
-    void fix_right_child(node_ptr& delete_node, node_ptr& successor)
+    /**
+     * @brief detaches a node from the tree without deallocating it
+     * if the node has no children or no left child
+     *  then the tree with root - the node is swapped with its right subtree
+     * if the node has no right child
+     *  then the tree with root - the node is swapped with its left subtree
+     * if the node has both left and right child
+     *  then the node is replaced with its successor
+     * the summaries of augmented nodes are updated from the lowest changed node - the parent of the fixup node
+     * if a black node has been removed from its place the tree is fixed
+     */
+    void unlink_node(node_ptr delete_node)
     {
+        NodeColor deleted_node_color = delete_node->get_color();
+        node_ptr fixup_node;
+
+        if(delete_node->left == null_node)
+        {
+            fixup_node = delete_node->right;
+            transplant(delete_node, delete_node->right);
+        }
+        else if(delete_node->right == null_node)
+        {
+            fixup_node = delete_node->left;
+            transplant(delete_node, delete_node->left);
+        }
+        else
+        {
+            node_ptr successor = get_successor(delete_node->right);
+            replace_with_successor(delete_node, successor, fixup_node, deleted_node_color);
+        }
 
-        delete_node->right = successor->right;
-        successor->right->parent = delete_node;
+        update_path(fixup_node->get_parent());
+
+        if (deleted_node_color == NodeColor :: Black)
+            delete_fixup(fixup_node);
     }
 
-//insert helper function
+// finger search helper function
 
-    node_ptr get_parent(const Type& value) const
+    /**
+     * @brief returns the root of a subtree around the finger that contains the position of the value,
+     *  so a search near the finger doesn't have to start from the root
+     * - all nodes on the way up are on the same side of the value as the finger,
+     *   the climb stops below the first ancestor on the other side - the value lies between them
+     * - for a finger at distance d from the value the climb is usually O(log d) levels
+     * - end() as a finger starts the search from the root
+     */
+    node_ptr finger_subtree(node_ptr finger, const Type& value) const
     {
-        node_ptr iter_parent = null_node;
-        node_ptr iter = root;
-    
-        while(iter != null_node)
+        if(finger == null_node)
+            return root;
+
+        std::weak_ordering order = compare(value, finger->value);
+
+        if(order == 0)
+            return finger;
+
+        for(node_ptr parent = finger->get_parent(); parent != null_node; parent = parent->get_parent())
         {
-            iter_parent = iter;
+            std::weak_ordering parent_order = compare(value, parent->value);
 
-            if(value < iter->value)
-                iter = iter->left;
-            else if(value > iter->value)
-                iter = iter->right;
-            else    
-                throw std::invalid_argument("Value already exists!");
+            if(parent_order == 0)
+                return parent;
+
+            if((parent_order < 0) != (order < 0))
+                break;
+
+            finger = parent;
         }
 
-        return iter_parent;
+        return finger;
     }
 
-public:
     /**
-     * @brief inserts a new element in the tree by conecting it to its parent and fixing the tree
-     *  if a violation has been caused
+     * @brief inserts the value below the subtree found from the finger, returns the new or the existing node
      */
-    void insert(const Type& value)
+    template <class Value>
+    node_ptr insert_value_near(node_ptr finger, Value&& value)
     {
-        node_ptr parent = get_parent(value);
-        node_ptr new_node = alloc.allocate(value, parent, null_node);
+        node_ptr parent;
+        bool is_left_child = false;
+        node_ptr existing = find_insert_position(value, parent, is_left_child, finger_subtree(finger, value));
 
-        if(parent == null_node)
-            root = new_node;
-        else if(new_node->value < parent->value)
-            parent->left = new_node;
-        else    
-            parent->right = new_node;
+        if(existing != null_node)
+            return existing;
 
-        insert_fixup(new_node);
+        node_ptr new_node = create_node(parent, std::forward<Value>(value));
+        link_new_node(parent, new_node, is_left_child);
+
+        return new_node;
     }
 
+// split and join helper function
+
     /**
-     * @brief erases an element from the tree
-     * if there is no such element - throws an exception
-     * if the node that contains the element has no childrem ot no left child
-     *  then the tree with root - the deleted node is swapped with its right subtree
-     * if the node that contains the element no right child
-     *  then the tree with root - the deleted node is swapped with its left subtree
-     * if the node that contains the element has both left and right child
-     *  then the value of the deleted node is swapped with its successors value
-     *  and if the successors parent is the deleted node
-     *   then the right child of the deleted node is fixed
-     *  otherwise the tree with root - the successor is swapped with its right subtree
+     * @brief takes the nodes of a subtree that belongs to another tree - the nodes are moved
+     *  from the allocator of the other tree to this one and their null children are relinked to this null node
+     * - the nodes are visited in preorder through the parent pointers, so the memory used doesn't depend
+     *   on the height of the subtree
+     * @return the root of the subtree in this tree (null_node for an empty subtree)
      */
-    void erase(const Type& value)
+    node_ptr adopt_nodes(node_ptr node, node_ptr other_null_node, node_allocator& other_alloc)
     {
-        node_ptr delete_node = find_node_with_value(value);
+        if(node == other_null_node)
+            return null_node;
 
-        if(delete_node == null_node)
-            throw std::invalid_argument("Value doesn't exist");
+        node_ptr subtree = node;
+        node_ptr from = nullptr;
 
-        NodeColor deleted_node_color = delete_node->color;
-        node_ptr fixup_node;
+        while(true)
+        {
+            node_ptr next = null_node;
 
-        if(delete_node->left == null_node)
+            if(from == nullptr)
+            {
+                other_alloc.release(node);
+                alloc.adopt(node);
+
+                if(node->left == other_null_node)
+                    node->left = null_node;
+
+                if(node->right == other_null_node)
+                    node->right = null_node;
+
+                next = node->left != null_node ? node->left : node->right;
+            }
+            else if(from == node->left)
+                next = node->right;
+
+            if(next != null_node)
+            {
+                node = next;
+                from = nullptr;
+                continue;
+            }
+
+            if(node == subtree)
+                return subtree;
+
+            from = node;
+            node = node->get_parent();
+        }
+    }
+
+// set operations helper function
+
+    /**
+     * @brief combines the nodes of two trees into one tree with a set operation on their subtrees
+     * - the result keeps the tree with the larger black height, the nodes of the other tree are moved to it,
+     *   so the bookkeeping is O(m) for the smaller tree
+     * - the nodes discarded by the operation are deallocated after all of its tasks are done
+     * @param operation - called with the result tree, both subtrees, the comparator and the list of discarded nodes
+     */
+    template <class Operation>
+    static RBTree combine_trees(RBTree&& first, RBTree&& second, Operation operation)
+    {
+        if(!node_transfer_traits<node_allocator>::compatible(first.alloc, second.alloc))
+            throw std::invalid_argument("The allocators of the trees are not compatible");
+
+        ThreeWayCompare<Type, Compare> compare = first.compare;
+        size_t first_height = first.tree_black_height;
+        size_t second_height = second.tree_black_height;
+        bool keep_first = first_height >= second_height;
+
+        RBTree result(std::move(keep_first ? first : second));
+        RBTree& other = keep_first ? second : first;
+
+        node_ptr other_root = result.adopt_nodes(other.root, other.null_node, other.alloc);
+        other.root = other.null_node;
+        other.tree_black_height = 0;
+
+        Subtree first_part = result.as_subtree(keep_first ? result.root : other_root, first_height);
+        Subtree second_part = result.as_subtree(keep_first ? other_root : result.root, second_height);
+
+        std::vector<node_ptr> discarded;
+        Subtree combined = operation(result, first_part, second_part, compare, discarded);
+        result.root = combined.root;
+        result.tree_black_height = combined.black_height;
+
+        for(node_ptr node : discarded)
+            result.delete_not_null_nodes(node);
+
+        return result;
+    }
+
+// assign_sorted helper function
+
+    /**
+     * @brief builds a perfectly balanced subtree of the next count elements, consuming them in order
+     * - the sizes of the two subtrees of every node differ by at most one, so all nodes are on the full levels
+     *   above red_depth or on the partial level at red_depth, which is colored red
+     * - the nodes are allocated by the given allocator and the null node isn't written,
+     *   so disjoint subtrees can be built by many threads with their own allocators
+     * - if an element can't be constructed the nodes built so far are deallocated
+     */
+    template <class Iterator>
+    node_ptr build_balanced(Iterator& iter, size_t count, size_t depth, size_t red_depth, node_allocator& allocator)
+    {
+        if(count == 0)
+            return null_node;
+
+        size_t left_count = (count - 1) / 2;
+        node_ptr left = build_balanced(iter, left_count, depth + 1, red_depth, allocator);
+        node_ptr node;
+
+        try
         {
-            fixup_node = delete_node->right;
-            transplant(delete_node, delete_node->right);
+            node = allocator.allocate(std::in_place, null_node, null_node, *iter);
         }
-        else if(delete_node->right == null_node)
+        catch(...)
         {
-            fixup_node = delete_node->left;
-            transplant(delete_node, delete_node->left);
+            delete_not_null_nodes(left, allocator);
+            throw;
         }
-        else
+
+        ++iter;
+
+        node_ptr right;
+
+        try
         {
-            node_ptr successor = get_successor(delete_node->right);
-            swap_values_of_delete_node_and_successor(delete_node, successor, fixup_node, deleted_node_color);
+            right = build_balanced(iter, count - 1 - left_count, depth + 1, red_depth, allocator);
+        }
+        catch(...)
+        {
+            delete_not_null_nodes(left, allocator);
+            allocator.deallocate(node);
+            throw;
+        }
+
+        link_built_node(node, left, right, depth == red_depth);
+
+        return node;
+    }
+
+    void link_built_node(node_ptr node, node_ptr left, node_ptr right, bool is_red)
+    {
+        node->left = left;
+        node->right = right;
+
+        if(left != null_node)
+            left->set_parent(node);
+
+        if(right != null_node)
+            right->set_parent(node);
+
+        node->set_color(is_red ? NodeColor :: Red : NodeColor :: Black);
+        update_node(node);
+    }
+
+    /**
+     * @brief the number of full levels of a perfectly balanced tree of count nodes,
+     *  the nodes below them (on the partial level) are colored red
+     */
+    static size_t full_levels(size_t count)
+    {
+        size_t levels = 0;
+
+        while((size_t(2) << levels) - 1 <= count)
+            ++levels;
+
+        return levels;
+    }
+
+    /**
+     * @brief replaces the elements of the empty tree with count sorted elements, see assign_sorted
+     */
+    template <class Iterator>
+    void build_sorted(Iterator first, size_t count)
+    {
+        if constexpr (has_reserve<node_allocator>::value)
+            alloc.reserve(count);
 
-            if(successor->parent == delete_node)
-                fix_right_child(delete_node, successor);                                         
-            else               
-                transplant(successor, successor->right);  
+        root = build_balanced(first, count, 0, full_levels(count), alloc);
+        root->set_parent(null_node);
+        root->make_black();
+        tree_black_height = full_levels(count);
+    }
+
+// build_parallel helper functions
+
+    /**
+     * @brief each thread of build_parallel builds a subtree of at least this many nodes
+     */
+    static constexpr size_t parallel_build_grain = size_t(1) << 14;
 
-            delete_node = successor;             
+    /**
+     * @brief splits the shape of the balanced tree of count sorted elements (from offset) at the given depth
+     * - the positions of the nodes above the depth are added to pivots in order,
+     *   the ranges of the subtrees at the depth - to subtrees
+     */
+    static void plan_parallel_build(size_t offset, size_t count, size_t depth, size_t split_depth,
+                                    std::vector<size_t>& pivots, std::vector<std::pair<size_t, size_t>>& subtrees)
+    {
+        if(depth == split_depth)
+        {
+            subtrees.push_back({offset, count});
+            return;
         }
 
-        alloc.deallocate(delete_node);  
+        size_t left_count = (count - 1) / 2;
 
-        if (deleted_node_color == NodeColor :: Black)
-            delete_fixup(fixup_node);
+        plan_parallel_build(offset, left_count, depth + 1, split_depth, pivots, subtrees);
+        pivots.push_back(offset + left_count);
+        plan_parallel_build(offset + left_count + 1, count - 1 - left_count, depth + 1, split_depth, pivots, subtrees);
     }
 
-    bool exists(const Type& value) const
+    /**
+     * @brief links the nodes above the split depth to each other and to the roots of the subtrees below it,
+     *  in the order of plan_parallel_build
+     */
+    node_ptr link_parallel_build(size_t depth, size_t split_depth, size_t red_depth,
+                                 std::span<node_ptr> pivot_nodes, size_t& next_pivot,
+                                 std::span<node_ptr> subtree_roots, size_t& next_subtree)
     {
-        return find_node_with_value(value) != null_node;
+        if(depth == split_depth)
+            return subtree_roots[next_subtree++];
+
+        node_ptr left = link_parallel_build(depth + 1, split_depth, red_depth, pivot_nodes, next_pivot, subtree_roots, next_subtree);
+        node_ptr node = pivot_nodes[next_pivot++];
+        node_ptr right = link_parallel_build(depth + 1, split_depth, red_depth, pivot_nodes, next_pivot, subtree_roots, next_subtree);
+
+        link_built_node(node, left, right, depth == red_depth);
+
+        return node;
     }
 
-    size_t black_height()const
+    /**
+     * @brief builds the balanced tree of the sorted elements with the subtrees below the top levels
+     *  built by parallel threads
+     * - every thread allocates its nodes with its own allocator, in one contiguous block for allocators with reserve,
+     *   and the allocators are merged into the allocator of the tree when all threads are done
+     * - the nodes of the top levels are allocated first by the calling thread
+     * - if an element can't be constructed all nodes are deallocated and the tree stays empty
+     */
+    template <class Iterator>
+    void build_sorted_parallel(Iterator first, size_t count, size_t threads)
     {
-        node_ptr iter = root;
-        size_t height = 0;
+        size_t split_depth = 0;
 
-        while(iter != null_node)
+        while((size_t(1) << split_depth) < threads)
+            ++split_depth;
+
+        std::vector<size_t> pivots;
+        std::vector<std::pair<size_t, size_t>> subtrees;
+        plan_parallel_build(0, count, 0, split_depth, pivots, subtrees);
+
+        std::vector<node_ptr> pivot_nodes;
+        pivot_nodes.reserve(pivots.size());
+
+        try
+        {
+            for(size_t pivot : pivots)
+                pivot_nodes.push_back(alloc.allocate(std::in_place, null_node, null_node, *(first + pivot)));
+        }
+        catch(...)
+        {
+            for(node_ptr node : pivot_nodes)
+                alloc.deallocate(node);
+
+            throw;
+        }
+
+        std::vector<node_allocator> allocators;
+        std::vector<node_ptr> subtree_roots(subtrees.size(), null_node);
+        size_t red_depth = full_levels(count);
+
+        for(size_t i = 0; i < subtrees.size(); ++i)
+            allocators.push_back(node_transfer_traits<node_allocator>::detached_allocator(alloc));
+
+        try
+        {
+            run_tasks(subtrees.size(), [&](size_t i){
+                Iterator iter = first + subtrees[i].first;
+
+                if constexpr (has_reserve<node_allocator>::value)
+                    allocators[i].reserve(subtrees[i].second);
+
+                subtree_roots[i] = build_balanced(iter, subtrees[i].second, split_depth, red_depth, allocators[i]);
+            });
+        }
+        catch(...)
         {
-            if(iter->is_black())
-                height++;
-            
-            iter = iter->left;
+            for(size_t i = 0; i < subtrees.size(); ++i)
+                delete_not_null_nodes(subtree_roots[i], allocators[i]);
+
+            for(node_ptr node : pivot_nodes)
+                alloc.deallocate(node);
+
+            throw;
         }
 
-        return height;
+        for(node_allocator& allocator : allocators)
+            alloc.merge(std::move(allocator));
+
+        size_t next_pivot = 0, next_subtree = 0;
+
+        root = link_parallel_build(0, split_depth, red_depth, pivot_nodes, next_pivot, subtree_roots, next_subtree);
+        root->set_parent(null_node);
+        root->make_black();
+        tree_black_height = red_depth;
     }
 
-    Allocator& get_allocator()
+// batch lookup helper functions
+
+    static constexpr size_t batch_group_size = 16;
+
+    static void prefetch_node(node_ptr node)
     {
-        return alloc;
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(node);
+#endif
     }
 
-    size_t height() const
+    /**
+     * @brief searches for groups of values at once, one level of every search in the group per round
+     * - the next node of each search is prefetched, so while it is loaded the other searches of the group
+     *   make progress instead of waiting for their own cache misses one after another
+     * - a finished search is marked with nullptr (null_node means that the value doesn't exist)
+     * @param output - called with the index of every value and its node or null_node
+     */
+    template <class Output>
+    void search_batch(std::span<const Type> values, Output&& output) const
     {
-        size_t max_height = 0;
+        node_ptr cursors[batch_group_size];
+
+        for(size_t first = 0; first < values.size(); first += batch_group_size)
+        {
+            size_t count = std::min(batch_group_size, values.size() - first);
+            bool in_flight = true;
 
-        calculate_height(root, max_height);
+            std::fill(cursors, cursors + count, root);
 
-        return max_height;
+            while(in_flight)
+            {
+                in_flight = false;
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    node_ptr node = cursors[i];
+
+                    if(!node)
+                        continue;
+
+                    std::weak_ordering order = node == null_node ? std::weak_ordering::equivalent 
+                                                                 : compare(values[first + i], node->value);
+
+                    if(order == 0)
+                    {
+                        output(first + i, node);
+                        cursors[i] = nullptr;
+                        continue;
+                    }
+
+                    node_ptr next = order < 0 ? node->left : node->right;
+
+                    prefetch_node(next);
+                    cursors[i] = next;
+                    in_flight = true;
+                }
+            }
+        }
     }
 
-    bool empty() const
+// range_aggregate helper functions
+
+    /**
+     * @brief the summary of the elements of the subtree that aren't ordered before low, in order
+     * - going down, every node that isn't before low is added before the summary so far together with its right subtree
+     */
+    auto suffix_aggregate(node_ptr node, const Type& low) const
     {
-        return root == null_node;
+        using augmentation = typename node_type :: augmentation;
+
+        auto result = augmentation :: identity();
+
+        while(node != null_node)
+        {
+            if(compare(node->value, low) < 0)
+                node = node->right;
+            else
+            {
+                result = augmentation :: combine(augmentation :: combine(augmentation :: lift(node->value), node->right->summary),
+                                                 result);
+                node = node->left;
+            }
+        }
+
+        return result;
     }
 
-    void clear()
+    /**
+     * @brief the summary of the elements of the subtree that are ordered before high, in order
+     * - the mirror of suffix_aggregate
+     */
+    auto prefix_aggregate(node_ptr node, const Type& high) const
     {
-        delete_not_null_nodes(root);
-        root = null_node;
+        using augmentation = typename node_type :: augmentation;
+
+        auto result = augmentation :: identity();
+
+        while(node != null_node)
+        {
+            if(compare(node->value, high) < 0)
+            {
+                result = augmentation :: combine(result, 
+                                                 augmentation :: combine(node->left->summary, augmentation :: lift(node->value)));
+                node = node->right;
+            }
+            else
+                node = node->left;
+        }
+
+        return result;
     }
-};
+
+//insert helper function
+
+    /**
+     * @brief finds where a new node with the given value should be linked in a single pass
+     * @return the node that already contains the value or null_node if there is no such node
+     * @param parent - the parent of the new node
+     * @param is_left_child - whether the new node should be a left child of its parent
+     */
+    node_ptr find_insert_position(const Type& value, node_ptr& parent, bool& is_left_child) const
+    {
+        return find_insert_position(value, parent, is_left_child, root);
+    }
+
+    /**
+     * @brief the same as above, but the search starts from a subtree that contains the position of the value
+     */
+    node_ptr find_insert_position(const Type& value, node_ptr& parent, bool& is_left_child, node_ptr start) const
+    {
+        parent = null_node;
+        node_ptr iter = start;
+    
+        while(iter != null_node)
+        {
+            std::weak_ordering order = compare(value, iter->value);
+
+            if(order == 0)
+                return iter;
+
+            parent = iter;
+            is_left_child = order < 0;
+            iter = is_left_child ? iter->left : iter->right;
+        }
+
+        return null_node;
+    }
+
+    void link_new_node(node_ptr parent, node_ptr new_node, bool is_left_child)
+    {
+        if(parent == null_node)
+            root = new_node;
+        else if(is_left_child)
+            parent->left = new_node;
+        else    
+            parent->right = new_node;
+
+        update_path(new_node);
+        insert_fixup(new_node);
+    }
+
+    /**
+     * @brief the parent is found before the node is allocated, 
+     *  so the value is copied or moved only once - directly into the new node
+     * - if the element already exists nothing is allocated and the existing node is returned
+     */
+    template <class Value>
+    std::pair<node_ptr, bool> insert_value(Value&& value)
+    {
+        node_ptr parent;
+        bool is_left_child = false;
+        node_ptr existing = find_insert_position(value, parent, is_left_child);
+
+        if(existing != null_node)
+            return {existing, false};
+
+        node_ptr new_node = create_node(parent, std::forward<Value>(value));
+        link_new_node(parent, new_node, is_left_child);
+
+        return {new_node, true};
+    }
+
+public:
+    /**
+     * @brief inserts a new element in the tree by conecting it to its parent and fixing the tree
+     *  if a violation has been caused
+     * - if the element already exists throws an exception
+     */
+    void insert(const Type& value)
+    {
+        if(!insert_value(value).second)
+            throw std::invalid_argument("Value already exists!");
+    }
+
+    void insert(Type&& value)
+    {
+        if(!insert_value(std::move(value)).second)
+            throw std::invalid_argument("Value already exists!");
+    }
+
+    /**
+     * @brief inserts the element if it doesn't exist, duplicates are reported instead of thrown
+     * @return an iterator to the element in the tree (the new or the existing one) and whether it has been inserted
+     * - only exceptions of the allocator, the comparator or the element's constructor can propagate
+     */
+    std::pair<iterator, bool> try_insert(const Type& value)
+    {
+        auto [node, inserted] = insert_value(value);
+
+        return {make_iterator(node), inserted};
+    }
+
+    std::pair<iterator, bool> try_insert(Type&& value)
+    {
+        auto [node, inserted] = insert_value(std::move(value));
+
+        return {make_iterator(node), inserted};
+    }
+
+    /**
+     * @brief inserts the element if it doesn't exist, the search starts from the hint (finger search),
+     *  so inserting sorted elements with the iterator returned by the previous insert is cheap
+     * @return an iterator to the new element or to the existing one (duplicates don't throw, as in std::set)
+     * - the hint has to be an iterator of this tree, end() starts the search from the root
+     */
+    const_iterator insert(const_iterator hint, const Type& value)
+    {
+        return make_iterator(insert_value_near(hint.node, value));
+    }
+
+    const_iterator insert(const_iterator hint, Type&& value)
+    {
+        return make_iterator(insert_value_near(hint.node, std::move(value)));
+    }
+
+    /**
+     * @brief inserts a batch of elements and returns how many of them were new
+     * - the batch is sorted in place and its duplicates are skipped, then each element is inserted through
+     *   the node of the previous one (as insert with a hint), so the search climbs only as far as the gap
+     *   between consecutive elements instead of descending from the root
+     * - if an element can't be copied the elements inserted before it stay in the tree
+     */
+    size_t insert_batch(std::span<Type> batch)
+    {
+        std::sort(batch.begin(), batch.end(), [this](const Type& lhs, const Type& rhs){
+            return compare(lhs, rhs) < 0;
+        });
+
+        node_ptr finger = null_node;
+        size_t inserted = 0;
+
+        for(size_t i = 0; i < batch.size(); ++i)
+        {
+            if(i > 0 && compare(batch[i - 1], batch[i]) == 0)
+                continue;
+
+            node_ptr parent;
+            bool is_left_child = false;
+            node_ptr existing = find_insert_position(batch[i], parent, is_left_child, finger_subtree(finger, batch[i]));
+
+            if(existing != null_node)
+            {
+                finger = existing;
+                continue;
+            }
+
+            finger = create_node(parent, batch[i]);
+            link_new_node(parent, finger, is_left_child);
+            ++inserted;
+        }
+
+        return inserted;
+    }
+
+    /**
+     * @brief constructs a new element in place from the given arguments and inserts it
+     * - the element is needed to find its parent, so the node is allocated first 
+     *   and if the element already exists the node is deallocated (or recycled) and an exception is thrown
+     */
+    template <class... Args>
+    void emplace(Args&&... args)
+    {
+        node_ptr new_node = create_node(null_node, std::forward<Args>(args)...);
+        node_ptr parent;
+        bool is_left_child = false;
+        node_ptr existing;
+
+        try
+        {
+            existing = find_insert_position(new_node->value, parent, is_left_child);
+        }
+        catch(...)
+        {
+            destroy_node(new_node);
+            throw;
+        }
+
+        if(existing != null_node)
+        {
+            destroy_node(new_node);
+            throw std::invalid_argument("Value already exists!");
+        }
+
+        new_node->set_parent(parent);
+        link_new_node(parent, new_node, is_left_child);
+    }
+
+    /**
+     * @brief erases an element from the tree
+     * if there is no such element - throws an exception
+     * otherwise the node that contains the element is detached from the tree and deallocated
+     */
+    void erase(const Type& value)
+    {
+        if(!try_erase(value))
+            throw std::invalid_argument("Value doesn't exist");
+    }
+
+    /**
+     * @brief erases the element if it exists, a missing element is reported instead of thrown
+     * @return the number of erased elements (0 or 1)
+     */
+    size_t try_erase(const Type& value)
+    {
+        node_ptr delete_node = find_node_with_value(value);
+
+        if(delete_node == null_node)
+            return 0;
+
+        unlink_node(delete_node);
+        destroy_node(delete_node);
+
+        return 1;
+    }
+
+    /**
+     * @brief erases the elements in [low, high) and returns how many were erased, O(log n + k) for k erased elements
+     * - the tree is split before low and before high and the outer parts are joined, so there is no search
+     *   and no delete fixup per element, only O(log n) restructuring
+     * - the nodes of the range are deallocated together at the end, they aren't recycled
+     */
+    size_t erase_range(const Type& low, const Type& high)
+    {
+        if(root == null_node || compare(low, high) >= 0)
+            return 0;
+
+        Subtree left, rest, range, right;
+
+        node_ptr found = split_subtree(as_subtree(root, tree_black_height), low, compare, left, rest);
+
+        if(found != null_node)
+            rest = join_subtrees({null_node, 0}, found, rest);
+
+        found = split_subtree(rest, high, compare, range, right);
+
+        if(found != null_node)
+            right = join_subtrees({null_node, 0}, found, right);
+
+        Subtree rest_of_tree = join_subtrees(left, right);
+        root = rest_of_tree.root;
+        tree_black_height = rest_of_tree.black_height;
+
+        return delete_not_null_nodes(range.root);
+    }
+
+    /**
+     * @brief detaches the node that contains the element from the tree and gives it to a node handle
+     *  without deallocating it, the handle can be inserted in another tree with a compatible allocator
+     * - if there is no such element an empty handle is returned
+     */
+    node_handle extract(const Type& value)
+    {
+        node_ptr extracted_node = find_node_with_value(value);
+
+        if(extracted_node == null_node)
+            return node_handle();
+
+        node_handle handle(extracted_node, alloc);
+        unlink_node(extracted_node);
+
+        return handle;
+    }
+
+    /**
+     * @brief inserts the node owned by the handle without allocating or copying the element
+     * - if the element already exists throws an exception and the handle keeps its node
+     * - if the allocator of the handle isn't compatible with the allocator of the tree throws an exception
+     */
+    void insert(node_handle&& handle)
+    {
+        if(handle.empty())
+            return;
+
+        if(!node_transfer_traits<node_allocator>::compatible(alloc, handle.alloc))
+            throw std::invalid_argument("Node handle allocator is not compatible");
+
+        node_ptr parent;
+        bool is_left_child = false;
+
+        if(find_insert_position(handle.node->value, parent, is_left_child) != null_node)
+            throw std::invalid_argument("Value already exists!");
+
+        node_ptr new_node = handle.release_to(alloc);
+
+        new_node->set_parent(parent);
+        new_node->left = null_node;
+        new_node->right = null_node;
+        new_node->make_red();
+
+        link_new_node(parent, new_node, is_left_child);
+    }
+
+    bool exists(const Type& value) const
+    {
+        return find_node_with_value(value) != null_node;
+    }
+
+    /**
+     * @brief checks many values at once - results[i] is whether values[i] exists
+     * - the searches are interleaved with prefetching (see search_batch), which hides the cache misses
+     *   of trees that don't fit in the cache
+     */
+    void exists_batch(std::span<const Type> values, std::span<bool> results) const
+    {
+        if(results.size() < values.size())
+            throw std::invalid_argument("Not enough space for the results");
+
+        search_batch(values, [&](size_t index, node_ptr node){
+            results[index] = node != null_node;
+        });
+    }
+
+    /**
+     * @brief finds many values at once - results[i] is an iterator to values[i] or end()
+     */
+    void find_batch(std::span<const Type> values, std::span<const_iterator> results) const
+    {
+        if(results.size() < values.size())
+            throw std::invalid_argument("Not enough space for the results");
+
+        search_batch(values, [&](size_t index, node_ptr node){
+            results[index] = make_iterator(node);
+        });
+    }
+
+    /**
+     * @brief returns an iterator to the element or end() if there is no such element
+     */
+    const_iterator find(const Type& value) const
+    {
+        return make_iterator(find_node_with_value(value));
+    }
+
+    /**
+     * @brief finger search - looks for the value starting from the hint instead of the root
+     *  and climbs only as far as needed, so a stream of sorted lookups where each one starts from the result
+     *  of the previous one costs O(log d) per lookup for a distance d between them
+     * - the hint has to be an iterator of this tree, end() starts the search from the root
+     */
+    const_iterator find(const_iterator hint, const Type& value) const
+    {
+        return make_iterator(find_node_with_value(value, finger_subtree(hint.node, value)));
+    }
+
+    /**
+     * @brief returns an iterator to the first element that isn't ordered before the value, or end()
+     */
+    const_iterator lower_bound(const Type& value) const
+    {
+        node_ptr bound = null_node;
+        node_ptr iter = root;
+
+        while(iter != null_node)
+        {
+            if(compare(iter->value, value) < 0)
+                iter = iter->right;
+            else
+            {
+                bound = iter;
+                iter = iter->left;
+            }
+        }
+
+        return make_iterator(bound);
+    }
+
+    /**
+     * @brief returns an iterator to the first element that is ordered after the value, or end()
+     */
+    const_iterator upper_bound(const Type& value) const
+    {
+        node_ptr bound = null_node;
+        node_ptr iter = root;
+
+        while(iter != null_node)
+        {
+            if(compare(value, iter->value) < 0)
+            {
+                bound = iter;
+                iter = iter->left;
+            }
+            else
+                iter = iter->right;
+        }
+
+        return make_iterator(bound);
+    }
+
+    /**
+     * @brief returns the range of elements equivalent to the value (at most one) with a single descent
+     * - the last node where the search turned left is the upper bound,
+     *   unless the element is found and has a right subtree - then its leftmost node is
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const Type& value) const
+    {
+        node_ptr upper = null_node;
+        node_ptr iter = root;
+
+        while(iter != null_node)
+        {
+            std::weak_ordering order = compare(value, iter->value);
+
+            if(order < 0)
+            {
+                upper = iter;
+                iter = iter->left;
+            }
+            else if(order > 0)
+                iter = iter->right;
+            else
+            {
+                if(iter->right != null_node)
+                    upper = get_successor(iter->right);
+
+                return {make_iterator(iter), make_iterator(upper)};
+            }
+        }
+
+        return {make_iterator(upper), make_iterator(upper)};
+    }
+
+    /**
+     * @brief calls the function with every element in [low, high) in order, in O(log n + k) for k elements
+     */
+    template <class Function>
+    void for_each_in_range(const Type& low, const Type& high, Function&& function) const
+    {
+        const_iterator last = end();
+
+        for(const_iterator iter = lower_bound(low); iter != last && compare(*iter, high) < 0; ++iter)
+            function(*iter);
+    }
+
+    /**
+     * @brief the number of elements in O(1), only for trees of nodes that know the size of their subtree
+     */
+    size_t size() const
+        requires has_subtree_size<node_type>::value
+    {
+        return root->size;
+    }
+
+    /**
+     * @brief returns an iterator to the k-th smallest element (counting from 0) or end() if k >= size()
+     */
+    const_iterator select(size_t k) const
+        requires has_subtree_size<node_type>::value
+    {
+        node_ptr iter = root;
+
+        while(iter != null_node)
+        {
+            size_t left_size = iter->left->size;
+
+            if(k < left_size)
+                iter = iter->left;
+            else if(k == left_size)
+                break;
+            else
+            {
+                k -= left_size + 1;
+                iter = iter->right;
+            }
+        }
+
+        return make_iterator(iter);
+    }
+
+    /**
+     * @brief returns the number of elements ordered before the value
+     */
+    size_t rank(const Type& value) const
+        requires has_subtree_size<node_type>::value
+    {
+        size_t smaller = 0;
+        node_ptr iter = root;
+
+        while(iter != null_node)
+        {
+            if(compare(value, iter->value) <= 0)
+                iter = iter->left;
+            else
+            {
+                smaller += iter->left->size + 1;
+                iter = iter->right;
+            }
+        }
+
+        return smaller;
+    }
+
+    /**
+     * @brief returns the number of elements in [low, high)
+     */
+    size_t count_range(const Type& low, const Type& high) const
+        requires has_subtree_size<node_type>::value
+    {
+        size_t low_rank = rank(low);
+        size_t high_rank = rank(high);
+
+        return high_rank > low_rank ? high_rank - low_rank : 0;
+    }
+
+    /**
+     * @brief the summary of all elements in O(1), only for trees of augmented nodes
+     */
+    auto aggregate() const
+        requires has_subtree_summary<node_type>::value
+    {
+        return root->summary;
+    }
+
+    /**
+     * @brief the summary of the elements in [low, high) in O(log n)
+     * - the descent stops at the highest node inside the range, 
+     *   below it the range is the suffix of its left subtree, the node itself and the prefix of its right subtree
+     */
+    auto range_aggregate(const Type& low, const Type& high) const
+        requires has_subtree_summary<node_type>::value
+    {
+        using augmentation = typename node_type :: augmentation;
+
+        node_ptr iter = root;
+
+        while(iter != null_node)
+        {
+            if(compare(iter->value, low) < 0)
+                iter = iter->right;
+            else if(compare(iter->value, high) >= 0)
+                iter = iter->left;
+            else
+                return augmentation :: combine(augmentation :: combine(suffix_aggregate(iter->left, low), 
+                                                                       augmentation :: lift(iter->value)),
+                                               prefix_aggregate(iter->right, high));
+        }
+
+        return augmentation :: identity();
+    }
+
+    const_iterator begin() const
+    {
+        if(root == null_node)
+            return end();
+
+        return make_iterator(get_successor(root));
+    }
+
+    const_iterator end() const
+    {
+        return make_iterator(null_node);
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief the number of black nodes on every path from the root to a leaf, O(1) - it is maintained by the operations
+     */
+    size_t black_height() const
+    {
+        return tree_black_height;
+    }
+
+    node_allocator& get_allocator()
+    {
+        return alloc;
+    }
+
+    const Compare& get_comparator() const
+    {
+        return compare.get_comparator();
+    }
+
+    /**
+     * @brief the number of nodes on the longest path from the root, O(n) - every node is visited (see walk_preorder)
+     */
+    size_t height() const
+    {
+        size_t max_height = 0;
+
+        walk_preorder(root, null_node, [&max_height](node_ptr, size_t depth){
+            max_height = std::max(max_height, depth);
+        });
+
+        return max_height;
+    }
+
+    /**
+     * @brief an upper bound of height() in O(1) - a path has no two red nodes in a row and starts with a black root,
+     *  so it has at most twice as many nodes as black ones
+     */
+    size_t height_upper_bound() const
+    {
+        return 2 * tree_black_height;
+    }
+
+    bool empty() const
+    {
+        return root == null_node;
+    }
+
+    void clear()
+    {
+        delete_tree();
+    }
+
+    /**
+     * @brief splits the tree at the key into the elements ordered before the key and the elements from the key on,
+     *  the tree is consumed, in O(log n + m) for the m elements of the lower part
+     * - the nodes are relinked in O(log n), nothing is copied or allocated except the null node of the new tree
+     * - the part with the larger black height keeps the tree and its allocator, the other part gets a compatible
+     *   allocator (as a node handle) and its nodes are moved to it one by one (see adopt_nodes), so splitting
+     *   near either end of a large tree moves only the few nodes cut off
+     */
+    std::pair<RBTree, RBTree> split(const Type& key) &&
+        requires has_node_release<node_allocator>::value
+    {
+        RBTree new_tree(compare, node_transfer_traits<node_allocator>::detached_allocator(alloc));
+
+        Subtree left, right;
+        node_ptr found = split_subtree(as_subtree(root, tree_black_height), key, compare, left, right);
+
+        if(found != null_node)
+            right = join_subtrees({null_node, 0}, found, right);
+
+        bool keep_left = left.black_height >= right.black_height;
+        Subtree kept = keep_left ? left : right;
+        Subtree moved = keep_left ? right : left;
+
+        root = kept.root;
+        tree_black_height = kept.black_height;
+
+        new_tree.root = new_tree.as_subtree(new_tree.adopt_nodes(moved.root, null_node, alloc), moved.black_height).root;
+        new_tree.tree_black_height = moved.black_height;
+
+        if(keep_left)
+            return {std::move(*this), std::move(new_tree)};
+
+        return {std::move(new_tree), std::move(*this)};
+    }
+
+    /**
+     * @brief joins two trees and a pivot ordered between them into one tree, both trees are consumed,
+     *  in O(log n + m) for the m elements of the lower tree
+     * - the nodes are relinked in O(log n) by linking the lower tree next to the spine of the higher one
+     *   (see join_subtrees), only the node of the pivot is allocated
+     * - the result keeps the allocator of the tree with the larger black height, the nodes of the other tree
+     *   are moved to it one by one (see adopt_nodes), so joining a small tree to a large one is cheap on either side
+     * - if the pivot isn't ordered between the trees or their allocators aren't compatible throws an exception
+     */
+    static RBTree join(RBTree&& left, const Type& pivot, RBTree&& right)
+        requires has_node_release<node_allocator>::value
+    {
+        if(!node_transfer_traits<node_allocator>::compatible(left.alloc, right.alloc))
+            throw std::invalid_argument("The allocators of the trees are not compatible");
+
+        if((!left.empty() && left.compare(*std::prev(left.end()), pivot) >= 0) 
+            || (!right.empty() && left.compare(pivot, *right.begin()) >= 0))
+            throw std::invalid_argument("The pivot is not ordered between the trees");
+
+        bool keep_left = left.tree_black_height >= right.tree_black_height;
+
+        RBTree result(std::move(keep_left ? left : right));
+        RBTree& other = keep_left ? right : left;
+        node_ptr pivot_node = result.create_node(result.null_node, pivot);
+
+        size_t other_height = std::exchange(other.tree_black_height, 0);
+        node_ptr other_root = result.adopt_nodes(other.root, other.null_node, other.alloc);
+        other.root = other.null_node;
+
+        Subtree kept = result.as_subtree(result.root, result.tree_black_height);
+        Subtree moved = result.as_subtree(other_root, other_height);
+
+        Subtree joined = keep_left ? result.join_subtrees(kept, pivot_node, moved)
+                                   : result.join_subtrees(moved, pivot_node, kept);
+        result.root = joined.root;
+        result.tree_black_height = joined.black_height;
+
+        return result;
+    }
+
+    /**
+     * @brief the union of two trees, both trees are consumed - for equal elements the element of the first tree is kept
+     * - join based divide and conquer: one tree is split at the root of the other one and the halves are united
+     *   recursively, O(m log(n/m + 1)) for trees with m <= n elements
+     * - the halves of large subtrees are united in parallel by up to the given number of threads
+     * - the nodes of the smaller tree are moved to the result (O(m) bookkeeping), see join
+     */
+    static RBTree set_union(RBTree&& first, RBTree&& second, size_t threads = std::thread::hardware_concurrency())
+        requires has_node_release<node_allocator>::value
+    {
+        return combine_trees(std::move(first), std::move(second),
+            [threads](RBTree& tree, Subtree first_part, Subtree second_part, const auto& compare, std::vector<node_ptr>& discarded){
+                return tree.union_subtrees(first_part, second_part, compare, discarded, threads);
+            });
+    }
+
+    /**
+     * @brief the elements of the first tree that are also in the second one, both trees are consumed, see set_union
+     */
+    static RBTree set_intersection(RBTree&& first, RBTree&& second, size_t threads = std::thread::hardware_concurrency())
+        requires has_node_release<node_allocator>::value
+    {
+        return combine_trees(std::move(first), std::move(second),
+            [threads](RBTree& tree, Subtree first_part, Subtree second_part, const auto& compare, std::vector<node_ptr>& discarded){
+                return tree.intersect_subtrees(first_part, second_part, compare, discarded, threads);
+            });
+    }
+
+    /**
+     * @brief the elements of the first tree that aren't in the second one, both trees are consumed, see set_union
+     */
+    static RBTree set_difference(RBTree&& first, RBTree&& second, size_t threads = std::thread::hardware_concurrency())
+        requires has_node_release<node_allocator>::value
+    {
+        return combine_trees(std::move(first), std::move(second),
+            [threads](RBTree& tree, Subtree first_part, Subtree second_part, const auto& compare, std::vector<node_ptr>& discarded){
+                return tree.subtract_subtrees(first_part, second_part, compare, discarded, threads);
+            });
+    }
+
+    /**
+     * @brief replaces the elements of the tree with a sorted range in O(n) - without searches and fixups
+     * - the range has to be strictly increasing by the comparator of the tree, otherwise an exception is thrown
+     *   before anything is changed
+     * - allocators with reserve (SlabAllocator) take the memory of all nodes in one block
+     * - the levels above the last one are full and black, the nodes of the last partial level are red
+     */
+    template <std::forward_iterator Iterator>
+    void assign_sorted(Iterator first, Iterator last)
+    {
+        size_t count = 0;
+
+        for(Iterator iter = first; iter != last; ++count)
+        {
+            Iterator previous = iter++;
+
+            if(iter != last && compare(*previous, *iter) >= 0)
+                throw std::invalid_argument("The range is not strictly increasing");
+        }
+
+        clear();
+        build_sorted(first, count);
+    }
+
+    /**
+     * @brief replaces the elements of the tree with the elements of an unsorted range, using many threads
+     * - the elements are copied and sorted in parallel - with radix sort for integral elements ordered by std::less,
+     *   otherwise with merge sort - and the duplicates are dropped
+     * - the balanced tree is built as in assign_sorted with the subtrees below the top levels built by parallel threads,
+     *   each with its own allocator (only for allocators with merge, otherwise the tree is built by this thread)
+     * - if copying or sorting the range throws the tree is left unchanged, if a node can't be built
+     *   the nodes built so far are deallocated and the tree is left empty
+     */
+    template <std::input_iterator Iterator>
+    void build_parallel(Iterator first, Iterator last, size_t threads = std::thread::hardware_concurrency())
+    {
+        std::vector<Type> values(first, last);
+
+        if constexpr (radix_sortable<Type, Compare>)
+            parallel_radix_sort(std::span<Type>(values), threads);
+        else
+            parallel_merge_sort(std::span<Type>(values), [this](const Type& lhs, const Type& rhs){
+                return compare(lhs, rhs) < 0;
+            }, threads);
+
+        values.erase(std::unique(values.begin(), values.end(), [this](const Type& lhs, const Type& rhs){
+            return compare(lhs, rhs) == 0;
+        }), values.end());
+
+        clear();
+
+        if constexpr (has_allocator_merge<node_allocator>::value)
+        {
+            if(threads > 1 && values.size() >= threads * parallel_build_grain)
+            {
+                build_sorted_parallel(std::make_move_iterator(values.begin()), values.size(), threads);
+                return;
+            }
+        }
+
+        build_sorted(std::make_move_iterator(values.begin()), values.size());
+    }
+};
+
+template <class Type, class Allocator, class Compare>
+void swap(RBTree<Type, Allocator, Compare>& lhs, RBTree<Type, Allocator, Compare>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
 
 #endif
\ No newline at end of file
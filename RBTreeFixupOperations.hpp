@@ -6,12 +6,41 @@
 template <class Type, class Allocator = MyAllocator<Node<Type>>>
 class RBTreeFixupOperations : public RBTreeMemoryManager<Type, Allocator>{
 private:
-    using node_ptr      = Node<Type>*;
-    using rotation_ptr  = void(RBTreeFixupOperations::*)(node_ptr);
+    using node_type     = node_t<Type, Allocator>;
+    using node_ptr      = node_type*;
+    using rotation_ptr  = void(RBTreeFixupOperations :: *)(node_ptr);
     
 protected:
-    using RBTreeMemoryManager<Type> :: null_node;
-    using RBTreeMemoryManager<Type> :: root;
+    using RBTreeMemoryManager<Type, Allocator> :: null_node;
+    using RBTreeMemoryManager<Type, Allocator> :: root;
+    using RBTreeMemoryManager<Type, Allocator> :: tree_black_height;
+
+public:
+    using RBTreeMemoryManager<Type, Allocator> :: RBTreeMemoryManager;
+
+protected:
+    /**
+     * @brief recomputes the subtree summary of an augmented node from its children
+     */
+    void update_node(node_ptr node)
+    {
+        if constexpr (is_augmented_node<node_type>::value)
+            node->recompute();
+    }
+
+    /**
+     * @brief recomputes the summaries of the node and all of its ancestors, bottom-up
+     * - it is called on the lowest node whose subtree has changed, before the fixup,
+     *   the rotations of the fixup update the nodes they move themselves
+     */
+    void update_path(node_ptr node)
+    {
+        if constexpr (is_augmented_node<node_type>::value)
+        {
+            for(; node != null_node; node = node->get_parent())
+                node->recompute();
+        }
+    }
 
     /**
      * @brief performs a left rotation from given node - makes the given node the right child of its left child:
@@ -23,12 +52,15 @@ protected:
         node_ptr right_child = node->right; 
 
         node->right = right_child->left; 
-        node->right->parent = node;
+        node->right->set_parent(node);
 
         transplant(node, right_child);
         
-        node->parent = right_child;
+        node->set_parent(right_child);
         right_child->left = node;
+
+        update_node(node);
+        update_node(right_child);
     }
 
     /**
@@ -41,12 +73,15 @@ protected:
         node_ptr left_child = node->left;
 
         node->left = left_child->right;
-        node->left->parent = node;
+        node->left->set_parent(node);
 
         transplant(node, left_child);
 
-        node->parent = left_child;
+        node->set_parent(left_child);
         left_child->right = node;
+
+        update_node(node);
+        update_node(left_child);
     }
 
     /**
@@ -54,14 +89,14 @@ protected:
      */
     void transplant(node_ptr& tree, node_ptr& subtree)
     {
-        if(tree->parent == null_node)
+        if(tree->get_parent() == null_node)
             root = subtree;
         else if(tree->is_left_child())
-            tree->parent->left = subtree;
+            tree->get_parent()->left = subtree;
         else
-            tree->parent->right = subtree;
+            tree->get_parent()->right = subtree;
 
-            subtree->parent = tree->parent;
+            subtree->set_parent(tree->get_parent());
     }
 
 protected:
@@ -79,38 +114,42 @@ protected:
      *     then the parent node is colored black and its parent - red, after a right rotation there are no longer
      *     two red nodes in a row(the fixup is done)
      * - if the parent is a right child - left should be swapped with right
+     * - if the root ends up red it is colored black, which adds one to the black height of the tree
      */
     void insert_fixup(node_ptr& violator)
     {
-        node_ptr parent_node = violator->parent;
+        node_ptr parent_node = violator->get_parent();
         node_ptr parents_sibling;
 
         while(parent_node->is_red())
         {
-            parents_sibling = parent_node->is_left_child() ? parent_node->parent->right : 
-                                                          parent_node->parent->left;
+            parents_sibling = parent_node->is_left_child() ? parent_node->get_parent()->right : 
+                                                          parent_node->get_parent()->left;
 
             if(parents_sibling->is_red()) //case 1
             {
                fix_parent_color(parents_sibling, parent_node);
-               violator = violator->parent->parent;
-               parent_node = violator->parent;
+               violator = violator->get_parent()->get_parent();
+               parent_node = violator->get_parent();
             }
             else
             {
                 if(parent_node->is_left_child())
                 {
                     ensure_violator_is_left_child(violator, parent_node); //case 2
-                    make_parent_node_black(parent_node, rotateRight); //case 3
+                    make_parent_node_black(parent_node, &RBTreeFixupOperations :: rotateRight); //case 3
                 }
                 else
                 {
                     ensure_violator_is_right_child(violator, parent_node); //case 2
-                    make_parent_node_black(parent_node, rotateLeft); // case 3
+                    make_parent_node_black(parent_node, &RBTreeFixupOperations :: rotateLeft); // case 3
                 }
             }
         }
 
+        if(root->is_red())
+            ++tree_black_height;
+
         root->make_black();
     }
 
@@ -121,7 +160,7 @@ private:
     {
         parents_sibling->make_black();
         parent_node->make_black();
-        parent_node->parent->make_red();
+        parent_node->get_parent()->make_red();
     }
     
     void ensure_violator_is_left_child(node_ptr& violator, node_ptr& parent_node)
@@ -130,7 +169,7 @@ private:
         {
             violator = parent_node;
             rotateLeft(violator);
-            parent_node = violator->parent;
+            parent_node = violator->get_parent();
         }
     }
 
@@ -140,20 +179,22 @@ private:
         {
             violator = parent_node;
             rotateRight(violator);
-            parent_node = violator->parent;
+            parent_node = violator->get_parent();
         }
     }
 
     void make_parent_node_black(node_ptr& parent_node, rotation_ptr rotation)
     {
         parent_node->make_black();
-        parent_node->parent->make_red();
-        (this->*rotation)(parent_node->parent);
+        parent_node->get_parent()->make_red();
+        (this->*rotation)(parent_node->get_parent());
     }
    
 protected:
     /**
      * @brief Moves the extra black node up the tree
+     * - if the extra black reaches the root it is dropped, which takes one from the black height of the tree
+     *   (unless case 4 has compensated it on the way)
      * 
      * @param fixup_node - always points to a nonroot doubly black node
      */
@@ -162,21 +203,26 @@ protected:
         node_ptr fixup_parent;
         node_ptr sibling;
 
+        bool compensated = false;
+
         while(root != fixup_node && fixup_node->is_black())
         {
-            fixup_parent = fixup_node->parent;
+            fixup_parent = fixup_node->get_parent();
 
             if(fixup_node->is_left_child())
             {
                 sibling = fixup_parent->right;
-                fixup_helper_left(fixup_node, sibling, fixup_parent);
+                compensated = fixup_helper_left(fixup_node, sibling, fixup_parent);
             } else
             {
                 sibling = fixup_parent->left;
-                fixup_helper_right(fixup_node, sibling, fixup_parent);
+                compensated = fixup_helper_right(fixup_node, sibling, fixup_parent);
             }
         }
 
+        if(!compensated && fixup_node->is_black())
+            --tree_black_height;
+
         fixup_node->make_black();
     }
 
@@ -197,12 +243,13 @@ private:
      * - if we fall in case 4 --sibling is black and its right child is red--
      *   then sibling is taking its parent color, the parent node and the red child are colored black
      *   after a left rotation the violating is fixed
+     * @return whether the extra black was compensated (case 4)
      */
-    void fixup_helper_left(node_ptr& fixup_node, node_ptr& sibling, node_ptr& fixup_parent)
+    bool fixup_helper_left(node_ptr& fixup_node, node_ptr& sibling, node_ptr& fixup_parent)
     {
         if(sibling->is_red()) //case 1
         {
-            make_sibling_black(sibling, fixup_parent, rotateLeft);
+            make_sibling_black(sibling, fixup_parent, &RBTreeFixupOperations :: rotateLeft);
             sibling = fixup_parent->right;
         }
 
@@ -210,18 +257,22 @@ private:
         {
             sibling->make_red();
             fixup_node = fixup_parent;
+
+            return false;
         }
         else
         {
             if(sibling->right->is_black()) //case 3
             {
-                swap_colors(sibling, sibling->left, rotateRight);
+                swap_colors(sibling, sibling->left, &RBTreeFixupOperations :: rotateRight);
                 sibling = fixup_parent->right;
             }
             
             //case 4
-            compensate_doubly_node(sibling, fixup_parent, sibling->right, rotateLeft);
+            compensate_doubly_node(sibling, fixup_parent, sibling->right, &RBTreeFixupOperations :: rotateLeft);
             fixup_node = root;
+
+            return true;
         }
     }
 
@@ -239,12 +290,13 @@ private:
      * - if we fall in case 4 --sibling is black and its left child is red--
      *   then sibling is taking its parent color, the parent node and the red child are colored black
      *   after a right rotation the violating is fixed
+     * @return whether the extra black was compensated (case 4)
      */
-    void fixup_helper_right(node_ptr& fixup_node, node_ptr& sibling, node_ptr& fixup_parent)
+    bool fixup_helper_right(node_ptr& fixup_node, node_ptr& sibling, node_ptr& fixup_parent)
     {
         if(sibling->is_red()) //case 1
         {
-            make_sibling_black(sibling, fixup_parent, rotateRight);
+            make_sibling_black(sibling, fixup_parent, &RBTreeFixupOperations :: rotateRight);
             sibling = fixup_parent->left;
         }
 
@@ -252,18 +304,22 @@ private:
         {
             sibling->make_red();
             fixup_node = fixup_parent;
+
+            return false;
         }
         else 
         {
             if(sibling->left->is_black()) //case 3
             {
-                swap_colors(sibling, sibling->right, rotateLeft);
+                swap_colors(sibling, sibling->right, &RBTreeFixupOperations :: rotateLeft);
                 sibling = fixup_parent->left;
             }
 
             // case 4
-            compensate_doubly_node(sibling, fixup_parent, sibling->left, rotateRight);
+            compensate_doubly_node(sibling, fixup_parent, sibling->left, &RBTreeFixupOperations :: rotateRight);
             fixup_node = root;
+
+            return true;
         }
     }
 
@@ -283,7 +339,7 @@ private:
 
     void compensate_doubly_node(node_ptr& sibling, node_ptr& parent_node, node_ptr& redChild, rotation_ptr rotation)
         {
-            sibling->color = parent_node->color;
+            sibling->set_color(parent_node->get_color());
             parent_node->make_black();
             redChild->make_black();
             (this->*rotation)(parent_node);
@@ -0,0 +1,150 @@
+#ifndef _RBTREE_ITERATOR_
+#define _RBTREE_ITERATOR_
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * @brief a constant bidirectional iterator that visits the elements of the tree in order
+ * - it walks through the parent pointers of the nodes, so it doesn't allocate
+ *   and an increment is amortized O(1)
+ * - end() points to the null node of the tree, the root of the tree is needed to step back from it
+ * - erasing other elements doesn't invalidate the iterator, because the nodes are relinked and never moved
+ */
+template <class NodeType>
+class RBTreeIterator{
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = std::remove_cv_t<decltype(NodeType::value)>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const value_type*;
+    using reference         = const value_type&;
+
+private:
+    template <class, class, class>
+    friend class RBTree;
+
+    using node_ptr = NodeType*;
+
+    node_ptr node;
+    node_ptr null_node;
+    const node_ptr* root;
+
+    RBTreeIterator(node_ptr node, node_ptr null_node, const node_ptr* root)
+        : node(node)
+        , null_node(null_node)
+        , root(root)
+    { }
+
+    node_ptr leftmost(node_ptr subtree) const
+    {
+        while(subtree->left != null_node)
+            subtree = subtree->left;
+
+        return subtree;
+    }
+
+    node_ptr rightmost(node_ptr subtree) const
+    {
+        while(subtree->right != null_node)
+            subtree = subtree->right;
+
+        return subtree;
+    }
+
+public:
+    RBTreeIterator()
+        : node(nullptr)
+        , null_node(nullptr)
+        , root(nullptr)
+    { }
+
+    reference operator*() const
+    {
+        return node->value;
+    }
+
+    pointer operator->() const
+    {
+        return &node->value;
+    }
+
+    /**
+     * @brief moves to the leftmost node of the right subtree,
+     *  or if there is no right subtree - to the first ancestor whose left subtree contains the node
+     */
+    RBTreeIterator& operator++()
+    {
+        if(node->right != null_node)
+        {
+            node = leftmost(node->right);
+            return *this;
+        }
+
+        node_ptr parent = node->get_parent();
+
+        while(parent != null_node && node == parent->right)
+        {
+            node = parent;
+            parent = parent->get_parent();
+        }
+
+        node = parent;
+
+        return *this;
+    }
+
+    /**
+     * @brief the mirror of operator++, from end() it moves to the largest element
+     */
+    RBTreeIterator& operator--()
+    {
+        if(node == null_node)
+        {
+            node = rightmost(*root);
+            return *this;
+        }
+
+        if(node->left != null_node)
+        {
+            node = rightmost(node->left);
+            return *this;
+        }
+
+        node_ptr parent = node->get_parent();
+
+        while(parent != null_node && node == parent->left)
+        {
+            node = parent;
+            parent = parent->get_parent();
+        }
+
+        node = parent;
+
+        return *this;
+    }
+
+    RBTreeIterator operator++(int)
+    {
+        RBTreeIterator temp = *this;
+        ++*this;
+
+        return temp;
+    }
+
+    RBTreeIterator operator--(int)
+    {
+        RBTreeIterator temp = *this;
+        --*this;
+
+        return temp;
+    }
+
+    bool operator==(const RBTreeIterator<NodeType>& other) const
+    {
+        return node == other.node;
+    }
+};
+
+#endif
@@ -0,0 +1,523 @@
+#ifndef _RBTREE_JOIN_
+#define _RBTREE_JOIN_
+
+#include "RBTreeFixupOperations.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <future>
+#include <system_error>
+#include <vector>
+
+/**
+ * @brief join and split of subtrees in O(log n) by relinking nodes, the building blocks of
+ *  split/join, erase_range and the set operations of the tree
+ * - the operations work on detached subtrees (Subtree) instead of the whole tree - they never write
+ *   the root of the tree or the null node, so disjoint subtrees can be joined and split in parallel
+ * - the set operations (union, intersection, difference) divide both subtrees at the root of one of them
+ *   and combine the halves in parallel tasks
+ */
+template <class Type, class Allocator = MyAllocator<Node<Type>>>
+class RBTreeJoinOperations : public RBTreeFixupOperations<Type, Allocator>{
+private:
+    using node_ptr = node_t<Type, Allocator>*;
+
+    /**
+     * @brief the halves of a set operation are combined in a new thread only if both subtrees have at least
+     *  this black height (at least 1023 nodes), smaller halves aren't worth starting a thread
+     */
+    static constexpr size_t parallel_black_height = 10;
+
+protected:
+    using RBTreeMemoryManager<Type, Allocator> :: null_node;
+
+    using RBTreeFixupOperations<Type, Allocator> :: update_node;
+    using RBTreeFixupOperations<Type, Allocator> :: update_path;
+
+public:
+    using RBTreeFixupOperations<Type, Allocator> :: RBTreeFixupOperations;
+
+protected:
+    /**
+     * @brief a detached subtree - its root has no parent and is black, black_height counts the root
+     */
+    struct Subtree{
+        node_ptr root;
+        size_t black_height;
+    };
+
+    /**
+     * @brief detaches the subtree of the node, whose black height is given, from its parent
+     * - a red root is colored black, which adds one to the black height
+     */
+    Subtree as_subtree(node_ptr node, size_t black_height) const
+    {
+        if(node == null_node)
+            return {null_node, 0};
+
+        node->set_parent(null_node);
+
+        if(node->is_red())
+        {
+            node->make_black();
+            ++black_height;
+        }
+
+        return {node, black_height};
+    }
+
+    /**
+     * @brief joins two subtrees and a pivot node ordered between them into one subtree
+     * - with equal black heights the pivot becomes the black root of both
+     * - otherwise the pivot is linked as a red node to the spine of the higher subtree, next to the first black node
+     *   with the black height of the lower subtree, and the red-red violation is fixed as after an insert
+     * - O(difference of the black heights + 1)
+     */
+    Subtree join_subtrees(Subtree left, node_ptr pivot, Subtree right)
+    {
+        if(left.black_height == right.black_height)
+        {
+            link_children(pivot, left.root, right.root);
+            pivot->set_parent(null_node);
+            pivot->make_black();
+            update_node(pivot);
+
+            return {pivot, left.black_height + 1};
+        }
+
+        if(left.black_height > right.black_height)
+            return join_into(left, pivot, right, right.black_height, true);
+
+        return join_into(right, pivot, left, left.black_height, false);
+    }
+
+    /**
+     * @brief joins two subtrees without a pivot - the last node of the left subtree is split off and becomes the pivot
+     */
+    Subtree join_subtrees(Subtree left, Subtree right)
+    {
+        if(left.root == null_node)
+            return right;
+
+        Subtree rest;
+        node_ptr last = split_last(left, rest);
+
+        return join_subtrees(rest, last, right);
+    }
+
+    /**
+     * @brief splits the subtree into the nodes ordered before the key and the nodes ordered after it
+     * - going down to the key, the nodes on the path are joined as pivots with the subtrees they leave behind,
+     *   the costs of the joins add up to O(log n)
+     * @param compare - a three-way comparator (ThreeWayCompare)
+     * @return the node with the key (detached from both parts) or null_node if there is no such node
+     */
+    template <class Compare>
+    node_ptr split_subtree(Subtree tree, const Type& key, const Compare& compare, Subtree& left, Subtree& right)
+    {
+        if(tree.root == null_node)
+        {
+            left = right = {null_node, 0};
+            return null_node;
+        }
+
+        node_ptr node = tree.root;
+        Subtree left_child = as_subtree(node->left, tree.black_height - 1);
+        Subtree right_child = as_subtree(node->right, tree.black_height - 1);
+        std::weak_ordering order = compare(key, node->value);
+
+        if(order == 0)
+        {
+            left = left_child;
+            right = right_child;
+            link_children(node, null_node, null_node);
+
+            return node;
+        }
+
+        node_ptr found;
+
+        if(order < 0)
+        {
+            Subtree middle;
+            found = split_subtree(left_child, key, compare, left, middle);
+            right = join_subtrees(middle, node, right_child);
+        }
+        else
+        {
+            Subtree middle;
+            found = split_subtree(right_child, key, compare, middle, right);
+            left = join_subtrees(left_child, node, middle);
+        }
+
+        return found;
+    }
+
+    /**
+     * @brief splits off the last node of a non-empty subtree, the other nodes are left in rest
+     */
+    node_ptr split_last(Subtree tree, Subtree& rest)
+    {
+        node_ptr node = tree.root;
+        Subtree left_child = as_subtree(node->left, tree.black_height - 1);
+
+        if(node->right == null_node)
+        {
+            rest = left_child;
+            link_children(node, null_node, null_node);
+
+            return node;
+        }
+
+        Subtree middle;
+        node_ptr last = split_last(as_subtree(node->right, tree.black_height - 1), middle);
+        rest = join_subtrees(left_child, node, middle);
+
+        return last;
+    }
+
+    /**
+     * @brief the union of two subtrees - for equal elements the node of the first subtree is kept
+     * - the second subtree is split at the root of the first one and the halves are united recursively,
+     *   O(m log(n/m + 1)) for subtrees with m <= n nodes
+     * - the nodes that are left out are added to discarded, they are deallocated by the caller
+     *   because the allocator isn't shared between the tasks
+     * @param tasks - how many tasks (threads) may combine the halves at once
+     */
+    template <class Compare>
+    Subtree union_subtrees(Subtree first, Subtree second, const Compare& compare, std::vector<node_ptr>& discarded, size_t tasks)
+    {
+        if(second.root == null_node)
+            return first;
+
+        if(first.root == null_node)
+            return second;
+
+        bool parallel = tasks > 1 && std::min(first.black_height, second.black_height) >= parallel_black_height;
+
+        Subtree first_left, first_right, second_left, second_right;
+        node_ptr pivot = expose(first, first_left, first_right);
+        node_ptr found = split_subtree(second, pivot->value, compare, second_left, second_right);
+
+        if(found != null_node)
+            discarded.push_back(found);
+
+        Subtree left, right;
+
+        for_halves(parallel, tasks, discarded,
+            [&](std::vector<node_ptr>& half_discarded, size_t half_tasks){
+                left = union_subtrees(first_left, second_left, compare, half_discarded, half_tasks);
+            },
+            [&](std::vector<node_ptr>& half_discarded, size_t half_tasks){
+                right = union_subtrees(first_right, second_right, compare, half_discarded, half_tasks);
+            });
+
+        return join_subtrees(left, pivot, right);
+    }
+
+    /**
+     * @brief the intersection of two subtrees - the nodes of the first subtree are kept, see union_subtrees
+     */
+    template <class Compare>
+    Subtree intersect_subtrees(Subtree first, Subtree second, const Compare& compare, std::vector<node_ptr>& discarded, size_t tasks)
+    {
+        if(first.root == null_node || second.root == null_node)
+        {
+            discard(first, discarded);
+            discard(second, discarded);
+
+            return {null_node, 0};
+        }
+
+        bool parallel = tasks > 1 && std::min(first.black_height, second.black_height) >= parallel_black_height;
+
+        Subtree first_left, first_right, second_left, second_right;
+        node_ptr pivot = expose(first, first_left, first_right);
+        node_ptr found = split_subtree(second, pivot->value, compare, second_left, second_right);
+
+        Subtree left, right;
+
+        for_halves(parallel, tasks, discarded,
+            [&](std::vector<node_ptr>& half_discarded, size_t half_tasks){
+                left = intersect_subtrees(first_left, second_left, compare, half_discarded, half_tasks);
+            },
+            [&](std::vector<node_ptr>& half_discarded, size_t half_tasks){
+                right = intersect_subtrees(first_right, second_right, compare, half_discarded, half_tasks);
+            });
+
+        if(found != null_node)
+        {
+            discarded.push_back(found);
+            return join_subtrees(left, pivot, right);
+        }
+
+        discarded.push_back(pivot);
+
+        return join_subtrees(left, right);
+    }
+
+    /**
+     * @brief the nodes of the first subtree that have no equal node in the second one, see union_subtrees
+     */
+    template <class Compare>
+    Subtree subtract_subtrees(Subtree first, Subtree second, const Compare& compare, std::vector<node_ptr>& discarded, size_t tasks)
+    {
+        if(first.root == null_node || second.root == null_node)
+        {
+            discard(second, discarded);
+
+            return first;
+        }
+
+        bool parallel = tasks > 1 && std::min(first.black_height, second.black_height) >= parallel_black_height;
+
+        Subtree first_left, first_right, second_left, second_right;
+        node_ptr pivot = expose(second, second_left, second_right);
+        node_ptr found = split_subtree(first, pivot->value, compare, first_left, first_right);
+
+        discarded.push_back(pivot);
+
+        if(found != null_node)
+            discarded.push_back(found);
+
+        Subtree left, right;
+
+        for_halves(parallel, tasks, discarded,
+            [&](std::vector<node_ptr>& half_discarded, size_t half_tasks){
+                left = subtract_subtrees(first_left, second_left, compare, half_discarded, half_tasks);
+            },
+            [&](std::vector<node_ptr>& half_discarded, size_t half_tasks){
+                right = subtract_subtrees(first_right, second_right, compare, half_discarded, half_tasks);
+            });
+
+        return join_subtrees(left, right);
+    }
+
+private:
+    /**
+     * @brief detaches the root of a non-empty subtree from its children, which are returned as subtrees
+     */
+    node_ptr expose(Subtree tree, Subtree& left, Subtree& right)
+    {
+        node_ptr node = tree.root;
+
+        left = as_subtree(node->left, tree.black_height - 1);
+        right = as_subtree(node->right, tree.black_height - 1);
+        link_children(node, null_node, null_node);
+
+        return node;
+    }
+
+    void discard(Subtree tree, std::vector<node_ptr>& discarded) const
+    {
+        if(tree.root != null_node)
+            discarded.push_back(tree.root);
+    }
+
+    /**
+     * @brief runs the tasks of the two halves of a set operation
+     * - in parallel the left half runs in a new thread with half of the tasks and collects its discarded nodes
+     *   in its own list, which is merged when both halves are done
+     * - if no thread can be started the left half runs after the right one
+     */
+    template <class LeftHalf, class RightHalf>
+    static void for_halves(bool parallel, size_t tasks, std::vector<node_ptr>& discarded, LeftHalf left_half, RightHalf right_half)
+    {
+        if(!parallel)
+        {
+            left_half(discarded, tasks);
+            right_half(discarded, tasks);
+
+            return;
+        }
+
+        std::vector<node_ptr> left_discarded;
+        std::future<void> left_task;
+
+        try
+        {
+            left_task = std::async(std::launch::async, left_half, std::ref(left_discarded), tasks / 2);
+        }
+        catch(const std::system_error&)
+        { }
+
+        right_half(discarded, tasks - tasks / 2);
+
+        if(left_task.valid())
+            left_task.get();
+        else
+            left_half(left_discarded, tasks / 2);
+
+        discarded.insert(discarded.end(), left_discarded.begin(), left_discarded.end());
+    }
+
+private:
+    void link_children(node_ptr node, node_ptr left, node_ptr right)
+    {
+        node->left = left;
+        node->right = right;
+
+        if(left != null_node)
+            left->set_parent(node);
+
+        if(right != null_node)
+            right->set_parent(node);
+    }
+
+    /**
+     * @brief links the pivot and the lower subtree to the higher subtree (on its right spine if into_left,
+     *  otherwise on its left spine) and fixes the tree
+     */
+    Subtree join_into(Subtree higher, node_ptr pivot, Subtree lower, size_t lower_height, bool into_left)
+    {
+        node_ptr parent = null_node;
+        node_ptr iter = higher.root;
+        size_t height = higher.black_height;
+
+        while(!(iter->is_black() && height == lower_height))
+        {
+            if(iter->is_black())
+                --height;
+
+            parent = iter;
+            iter = into_left ? iter->right : iter->left;
+        }
+
+        if(into_left)
+        {
+            link_children(pivot, iter, lower.root);
+            parent->right = pivot;
+        }
+        else
+        {
+            link_children(pivot, lower.root, iter);
+            parent->left = pivot;
+        }
+
+        pivot->set_parent(parent);
+        pivot->make_red();
+        update_path(pivot);
+
+        join_fixup(pivot, higher);
+
+        return higher;
+    }
+
+    /**
+     * @brief the insert fixup limited to a subtree - the rotations don't write the null node or the root of the tree
+     */
+    void join_fixup(node_ptr violator, Subtree& tree)
+    {
+        while(violator != tree.root && violator->get_parent()->is_red())
+        {
+            node_ptr parent = violator->get_parent();
+            node_ptr grandparent = parent->get_parent();
+
+            if(parent == grandparent->left)
+            {
+                node_ptr uncle = grandparent->right;
+
+                if(uncle->is_red())
+                {
+                    parent->make_black();
+                    uncle->make_black();
+                    grandparent->make_red();
+                    violator = grandparent;
+                    continue;
+                }
+
+                if(violator == parent->right)
+                {
+                    violator = parent;
+                    rotate_left_in_subtree(violator, tree);
+                    parent = violator->get_parent();
+                }
+
+                parent->make_black();
+                grandparent->make_red();
+                rotate_right_in_subtree(grandparent, tree);
+            }
+            else
+            {
+                node_ptr uncle = grandparent->left;
+
+                if(uncle->is_red())
+                {
+                    parent->make_black();
+                    uncle->make_black();
+                    grandparent->make_red();
+                    violator = grandparent;
+                    continue;
+                }
+
+                if(violator == parent->left)
+                {
+                    violator = parent;
+                    rotate_right_in_subtree(violator, tree);
+                    parent = violator->get_parent();
+                }
+
+                parent->make_black();
+                grandparent->make_red();
+                rotate_left_in_subtree(grandparent, tree);
+            }
+        }
+
+        if(tree.root->is_red())
+        {
+            tree.root->make_black();
+            ++tree.black_height;
+        }
+    }
+
+    void replace_child(node_ptr parent, node_ptr old_child, node_ptr new_child, Subtree& tree)
+    {
+        new_child->set_parent(parent);
+
+        if(parent == null_node)
+            tree.root = new_child;
+        else if(parent->left == old_child)
+            parent->left = new_child;
+        else
+            parent->right = new_child;
+    }
+
+    void rotate_left_in_subtree(node_ptr node, Subtree& tree)
+    {
+        node_ptr right_child = node->right;
+
+        node->right = right_child->left;
+
+        if(node->right != null_node)
+            node->right->set_parent(node);
+
+        replace_child(node->get_parent(), node, right_child, tree);
+
+        node->set_parent(right_child);
+        right_child->left = node;
+
+        update_node(node);
+        update_node(right_child);
+    }
+
+    void rotate_right_in_subtree(node_ptr node, Subtree& tree)
+    {
+        node_ptr left_child = node->left;
+
+        node->left = left_child->right;
+
+        if(node->left != null_node)
+            node->left->set_parent(node);
+
+        replace_child(node->get_parent(), node, left_child, tree);
+
+        node->set_parent(left_child);
+        left_child->right = node;
+
+        update_node(node);
+        update_node(left_child);
+    }
+};
+
+#endif
@@ -3,53 +3,350 @@
 
 #include "Node.hpp"
 #include "MyAllocator.hpp"
+#include "NodeAllocatorTraits.hpp"
+
+#include <type_traits>
+#include <utility>
 
 template <class Type, class Allocator = MyAllocator<Node<Type>>>
 class RBTreeMemoryManager{
 protected:
-    using node_ptr = Node<Type>*;
+    using node_ptr = node_t<Type, Allocator>*;
+    using node_allocator = node_allocator_t<Type, Allocator>;
 
     node_ptr root;
     node_ptr null_node;
-    MyAllocator<Node<Type>> alloc;
+    node_allocator alloc;
+
+    /**
+     * @brief the black height of the tree, kept up to date by every operation that changes the tree
+     */
+    size_t tree_black_height = 0;
+
+    /**
+     * @brief nodes of erased elements kept for the next inserts, linked through their right pointers
+     * - a recycled node keeps its old element, the new element is assigned to it
+     * - at most recycle_limit nodes are kept (none by default)
+     */
+    node_ptr recycled_nodes = nullptr;
+    size_t recycled_count = 0;
+    size_t recycle_limit = 0;
+
+    /**
+     * @brief deallocates the nodes of the subtree and returns how many there were
+     */
+    size_t delete_not_null_nodes(node_ptr node)
+    {
+        return delete_not_null_nodes(node, alloc);
+    }
 
-    void delete_not_null_nodes(node_ptr node)
+    /**
+     * @brief deallocates the nodes of a subtree allocated by another allocator (while the tree is built by many threads)
+     * - the nodes are deallocated bottom-up through the parent pointers - a node without children is deallocated
+     *   and unlinked from its parent - so the memory used doesn't depend on the height of the subtree
+     */
+    size_t delete_not_null_nodes(node_ptr node, node_allocator& allocator)
     {
         if(node == null_node)
+            return 0;
+
+        node_ptr subtree = node;
+        size_t count = 0;
+
+        while(true)
+        {
+            if(node->left != null_node)
+                node = node->left;
+            else if(node->right != null_node)
+                node = node->right;
+            else
+            {
+                node_ptr parent = node->get_parent();
+                bool is_subtree = node == subtree;
+
+                if(!is_subtree)
+                {
+                    if(parent->left == node)
+                        parent->left = null_node;
+                    else
+                        parent->right = null_node;
+                }
+
+                allocator.deallocate(node);
+                ++count;
+
+                if(is_subtree)
+                    return count;
+
+                node = parent;
+            }
+        }
+    }
+
+    /**
+     * @brief visits the nodes of the subtree in preorder with their depths (the root of the subtree has depth 1)
+     * - the walk follows the parent pointers instead of a stack, so the memory used doesn't depend on the height
+     */
+    template <class Visit>
+    static void walk_preorder(node_ptr subtree, node_ptr null, Visit&& visit)
+    {
+        if(subtree == null)
             return;
 
-        delete_not_null_nodes(node->left);
-        delete_not_null_nodes(node->right);
+        node_ptr node = subtree;
+        node_ptr from = null;
+        size_t depth = 1;
+
+        while(true)
+        {
+            node_ptr next = null;
+
+            if(from == null)
+            {
+                visit(node, depth);
+                next = node->left != null ? node->left : node->right;
+            }
+            else if(from == node->left)
+                next = node->right;
+
+            if(next != null)
+            {
+                node = next;
+                from = null;
+                ++depth;
+                continue;
+            }
+
+            if(node == subtree)
+                return;
+
+            from = node;
+            node = node->get_parent();
+            --depth;
+        }
+    }
+
+    /**
+     * @brief deallocates all nodes except the null node and leaves the tree empty
+     * - allocators with region release drop all nodes at once and a new null node is allocated
+     * - a moved-from tree has no null node, it gets a new one so it can be used again
+     */
+    void delete_tree()
+    {
+        if constexpr (has_region_release<node_allocator>::value)
+        {
+            alloc.deallocate_all();
+            forget_recycled_nodes();
+            null_node = alloc.allocate();
+        }
+        else
+        {
+            delete_not_null_nodes(root);
+            delete_recycled_nodes();
+
+            if(!null_node)
+                null_node = alloc.allocate();
+        }
+
+        root = null_node;
+        tree_black_height = 0;
+    }
+
+    /**
+     * @brief returns a new red node with the given parent whose element is constructed from the arguments
+     * - if there is a recycled node it is reused and the element is assigned to it
+     */
+    template <class... Args>
+    node_ptr create_node(node_ptr parent, Args&&... args)
+    {
+        if(!recycled_nodes)
+            return alloc.allocate(std::in_place, parent, null_node, std::forward<Args>(args)...);
+
+        node_ptr node = recycled_nodes;
+        assign_value(node->value, std::forward<Args>(args)...);
+
+        recycled_nodes = node->right;
+        --recycled_count;
+
+        node->set_parent(parent);
+        node->left = null_node;
+        node->right = null_node;
+        node->make_red();
 
-        alloc.deallocate(node);
+        return node;
+    }
+
+    /**
+     * @brief keeps the node for the next inserts if there is space in the recycle list, otherwise deallocates it
+     */
+    void destroy_node(node_ptr node)
+    {
+        if(recycled_count < recycle_limit)
+        {
+            node->right = recycled_nodes;
+            recycled_nodes = node;
+            ++recycled_count;
+        }
+        else
+            alloc.deallocate(node);
     }
 
 private:
-    node_ptr copy_helper(node_ptr parent, node_ptr other_node, const node_ptr& other_null_node)
+    template <class Value>
+        requires std::is_assignable_v<Type&, Value&&>
+    static void assign_value(Type& value, Value&& new_value)
+    {
+        value = std::forward<Value>(new_value);
+    }
+
+    template <class... Args>
+    static void assign_value(Type& value, Args&&... args)
     {
-        if(other_node == other_null_node)
-            return null_node;
+        value = Type(std::forward<Args>(args)...);
+    }
+
+    void delete_recycled_nodes()
+    {
+        while(recycled_nodes)
+            alloc.deallocate(std::exchange(recycled_nodes, recycled_nodes->right));
 
-        node_ptr current = alloc.allocate(other_node);
-        current->parent = parent;
+        recycled_count = 0;
+    }
 
-        current->left = copy_helper(current, other_node->left, other_null_node);
-        current->right = copy_helper(current, other_node->right, other_null_node);
+    void forget_recycled_nodes()
+    {
+        recycled_nodes = nullptr;
+        recycled_count = 0;
+    }
 
-        return current;
+    /**
+     * @brief the allocator of a copied tree - allocators that can be copied decide themselves what a copy is,
+     *  the others are default constructed
+     */
+    static node_allocator allocator_for_copy(const node_allocator& other)
+    {
+        if constexpr (std::is_copy_constructible_v<node_allocator>)
+            return node_allocator(other);
+        else
+            return node_allocator();
     }
 
+    /**
+     * @brief copies the nodes of the other tree in preorder without recursion
+     * - until its right subtree is copied, a copied node keeps its source node in its right pointer,
+     *   so the walk climbs through the parent pointers of the copy and reads every source node only twice
+     * - allocators with reserve (SlabAllocator) take the memory of all nodes in one block first, so the copy
+     *   is laid out in preorder - a node is followed by its left subtree; the block is as big as the number
+     *   of nodes the other allocator counts, which also covers the null node and the recycled nodes
+     * - if an element can't be copied the nodes copied so far are deallocated and the tree is left empty
+     */
     void copy(const RBTreeMemoryManager& other)
     {
+        if constexpr (has_reserve<node_allocator>::value && has_allocation_count<node_allocator>::value)
+            alloc.reserve(other.alloc.size());
+
         null_node = alloc.allocate();
+        root = null_node;
+        tree_black_height = 0;
+
+        if(other.root == other.null_node)
+            return;
+
+        node_ptr target = null_node;
+
+        try
+        {
+            target = root = copy_node(null_node, other.root);
+
+            while(true)
+            {
+                if(target->right->left != other.null_node)
+                {
+                    target = target->left = copy_node(target, target->right->left);
+                    continue;
+                }
+
+                while(target->right->right == other.null_node)
+                {
+                    target->right = null_node;
 
-        root = copy_helper(null_node, other.root, other.null_node);
+                    node_ptr child;
+
+                    do
+                    {
+                        child = target;
+                        target = target->get_parent();
+                    }
+                    while(target != null_node && child == target->right);
+
+                    if(target == null_node)
+                    {
+                        tree_black_height = other.tree_black_height;
+                        return;
+                    }
+                }
+
+                node_ptr source = target->right;
+                target = target->right = copy_node(target, source->right);
+            }
+        }
+        catch(...)
+        {
+            for(node_ptr child = nullptr; target != null_node; child = target, target = target->get_parent())
+                if(child == nullptr || child == target->left)
+                    target->right = null_node;
+
+            delete_not_null_nodes(root);
+            root = null_node;
+            throw;
+        }
+    }
+
+    /**
+     * @brief returns a copy of the other node whose right pointer keeps the other node
+     */
+    node_ptr copy_node(node_ptr parent, node_ptr other_node)
+    {
+        node_ptr node = alloc.allocate(other_node);
+
+        node->set_parent(parent);
+        node->left = null_node;
+        node->right = other_node;
+
+        return node;
+    }
+
+    /**
+     * @brief takes the nodes and the allocator of the other tree,
+     *  the other tree is left without nodes - it can only be assigned to, cleared or destroyed
+     */
+    void steal(RBTreeMemoryManager& other) noexcept
+    {
+        root = std::exchange(other.root, nullptr);
+        null_node = std::exchange(other.null_node, nullptr);
+        alloc = std::move(other.alloc);
+        tree_black_height = std::exchange(other.tree_black_height, 0);
+        recycled_nodes = std::exchange(other.recycled_nodes, nullptr);
+        recycled_count = std::exchange(other.recycled_count, 0);
+        recycle_limit = other.recycle_limit;
     }
 
     void delete_all_nodes()
     {
-        delete_not_null_nodes(root);
-        alloc.deallocate(null_node);
+        if(!null_node)
+            return;
+
+        if constexpr (has_region_release<node_allocator>::value)
+        {
+            alloc.deallocate_all();
+            forget_recycled_nodes();
+        }
+        else
+        {
+            delete_not_null_nodes(root);
+            delete_recycled_nodes();
+            alloc.deallocate(null_node);
+        }
     }
 
 public: 
@@ -59,22 +356,137 @@ public:
         root = null_node;
     }
 
-    RBTreeMemoryManager(const RBTreeMemoryManager<Type, Allocator>& other) : alloc()
+    /**
+     * @brief constructs an empty tree whose nodes are allocated through a copy of the given allocator
+     */
+    explicit RBTreeMemoryManager(const Allocator& allocator)
+        : alloc(allocator)
+    {
+        null_node = alloc.allocate();
+        root = null_node;
+    }
+
+    /**
+     * @brief constructs an empty tree that allocates through the given node allocator,
+     *  used for trees that take nodes from another tree
+     */
+    RBTreeMemoryManager(std::in_place_t, node_allocator&& allocator)
+        : alloc(std::move(allocator))
     {
-        copy(other);
+        null_node = alloc.allocate();
+        root = null_node;
     }
 
+    RBTreeMemoryManager(const RBTreeMemoryManager<Type, Allocator>& other) 
+        : null_node(nullptr)
+        , alloc(allocator_for_copy(other.alloc))
+        , recycle_limit(other.recycle_limit)
+    {
+        try
+        {
+            copy(other);
+        }
+        catch(...)
+        {
+            if(null_node)
+                alloc.deallocate(null_node);
+
+            throw;
+        }
+    }
+
+    /**
+     * @brief takes the nodes of the other tree in O(1) without allocating
+     * - the moved-from tree can only be assigned to, cleared or destroyed
+     */
+    RBTreeMemoryManager(RBTreeMemoryManager<Type, Allocator>&& other) noexcept
+        : root(std::exchange(other.root, nullptr))
+        , null_node(std::exchange(other.null_node, nullptr))
+        , alloc(std::move(other.alloc))
+        , tree_black_height(std::exchange(other.tree_black_height, 0))
+        , recycled_nodes(std::exchange(other.recycled_nodes, nullptr))
+        , recycled_count(std::exchange(other.recycled_count, 0))
+        , recycle_limit(other.recycle_limit)
+    { }
+
     RBTreeMemoryManager& operator=(const RBTreeMemoryManager<Type, Allocator>& other)
     {
         if(this != &other)
         {
             delete_all_nodes();
             copy(other);
+            recycle_limit = other.recycle_limit;
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief takes the nodes of the other tree in O(1)
+     * - if the allocators don't allow it (standard allocators that don't propagate and compare unequal)
+     *   the nodes are copied instead
+     */
+    RBTreeMemoryManager& operator=(RBTreeMemoryManager<Type, Allocator>&& other) 
+        noexcept(node_transfer_traits<node_allocator>::always_on_move)
+    {
+        if(this != &other)
+        {
+            delete_all_nodes();
+
+            if(node_transfer_traits<node_allocator>::on_move(alloc, other.alloc))
+                steal(other);
+            else
+            {
+                copy(other);
+                recycle_limit = other.recycle_limit;
+            }
         }
 
         return *this;
     }
 
+    /**
+     * @brief exchanges the nodes and the allocators of both trees in O(1)
+     */
+    void swap(RBTreeMemoryManager<Type, Allocator>& other) noexcept
+    {
+        std::swap(root, other.root);
+        std::swap(null_node, other.null_node);
+        std::swap(alloc, other.alloc);
+        std::swap(tree_black_height, other.tree_black_height);
+        std::swap(recycled_nodes, other.recycled_nodes);
+        std::swap(recycled_count, other.recycled_count);
+        std::swap(recycle_limit, other.recycle_limit);
+    }
+
+    /**
+     * @brief sets how many nodes of erased elements are kept for reuse by the next inserts,
+     *  the extra recycled nodes are deallocated
+     */
+    void set_recycle_limit(size_t limit)
+    {
+        recycle_limit = limit;
+
+        while(recycled_count > recycle_limit)
+        {
+            alloc.deallocate(std::exchange(recycled_nodes, recycled_nodes->right));
+            --recycled_count;
+        }
+    }
+
+    size_t get_recycle_limit() const
+    {
+        return recycle_limit;
+    }
+
+    /**
+     * @brief deallocates all recycled nodes
+     */
+    void shrink_to_fit()
+    {
+        delete_recycled_nodes();
+    }
+
     ~RBTreeMemoryManager()
     {
         delete_all_nodes();
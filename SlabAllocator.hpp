@@ -0,0 +1,315 @@
+#ifndef _SLAB_ALLOCATOR_
+#define _SLAB_ALLOCATOR_
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AllocationTracking.hpp"
+
+/**
+ * @brief allocates objects out of large contiguous slabs
+ * - freed objects are kept in an intrusive free list and reused by the next allocation
+ * - a new slab is requested only when the free list is empty and the current slab is used up,
+ *   every new slab is twice as big as the previous one (up to max_slab_size objects)
+ * - the memory of the slabs is returned to the system when the allocator is destroyed
+ *   or all at once by deallocate_all
+ * - TrackingPolicy is the same as in MyAllocator, by default only the number of live objects is counted
+ */
+template <class Type, class TrackingPolicy = CountOnly>
+class SlabAllocator{
+private:
+    union Slot{
+        Slot* next;
+        alignas(Type) unsigned char storage[sizeof(Type)];
+    };
+
+    static constexpr size_t min_slab_size = 64;
+    static constexpr size_t max_slab_size = size_t(1) << 16;
+
+    struct Slab{
+        std::unique_ptr<Slot[]> slots;
+        size_t size;
+    };
+
+    std::vector<Slab> slabs;
+    Slot* free_list;
+    Slot* next_unused;
+    Slot* slab_end;
+    size_t reserved;
+    size_t next_slab_size;
+    AllocationRegistry<Type, TrackingPolicy> allocated;
+
+    void add_slab(size_t slab_size)
+    {
+        slabs.push_back({std::unique_ptr<Slot[]>(new Slot[slab_size]), slab_size});
+
+        next_unused = slabs.back().slots.get();
+        slab_end = next_unused + slab_size;
+    }
+
+    Slot* get_free_slot()
+    {
+        if(reserved)
+        {
+            --reserved;
+
+            return next_unused++;
+        }
+
+        if(free_list)
+        {
+            Slot* slot = free_list;
+            free_list = free_list->next;
+
+            return slot;
+        }
+
+        if(next_unused == slab_end)
+        {
+            add_slab(next_slab_size);
+
+            if(next_slab_size < max_slab_size)
+                next_slab_size *= 2;
+        }
+
+        return next_unused++;
+    }
+
+    void put_free_slot(Slot* slot)
+    {
+        slot->next = free_list;
+        free_list = slot;
+    }
+
+    /**
+     * @brief calls the destructor of every live object with a linear sweep over the slabs
+     * - the slots in the free list are marked first, every other slot before next_unused holds a live object
+     */
+    void destroy_live_objects()
+    {
+        std::vector<size_t> by_address(slabs.size());
+        std::vector<std::vector<bool>> is_free(slabs.size());
+
+        for(size_t i = 0; i < slabs.size(); ++i)
+        {
+            by_address[i] = i;
+            is_free[i].resize(slabs[i].size);
+        }
+
+        std::sort(by_address.begin(), by_address.end(), [this](size_t lhs, size_t rhs){
+            return std::less<Slot*>()(slabs[lhs].slots.get(), slabs[rhs].slots.get());
+        });
+
+        for(Slot* slot = free_list; slot; slot = slot->next)
+        {
+            auto after = std::upper_bound(by_address.begin(), by_address.end(), slot, [this](Slot* ptr, size_t index){
+                return std::less<Slot*>()(ptr, slabs[index].slots.get());
+            });
+            size_t index = *(after - 1);
+
+            is_free[index][slot - slabs[index].slots.get()] = true;
+        }
+
+        for(size_t i = 0; i < slabs.size(); ++i)
+        {
+            Slot* begin = slabs[i].slots.get();
+            Slot* end = (i + 1 == slabs.size()) ? next_unused : begin + slabs[i].size;
+
+            for(Slot* slot = begin; slot != end; ++slot)
+                if(!is_free[i][slot - begin])
+                    std::launder(reinterpret_cast<Type*>(slot->storage))->~Type();
+        }
+    }
+
+public:
+    SlabAllocator()
+        : free_list(nullptr)
+        , next_unused(nullptr)
+        , slab_end(nullptr)
+        , reserved(0)
+        , next_slab_size(min_slab_size)
+    { }
+
+    SlabAllocator(const SlabAllocator<Type, TrackingPolicy>& other) = delete;
+    SlabAllocator& operator=(const SlabAllocator<Type, TrackingPolicy>& other) = delete;
+
+    /**
+     * @brief takes the slabs of the other allocator and leaves it empty
+     */
+    SlabAllocator(SlabAllocator<Type, TrackingPolicy>&& other) noexcept
+        : slabs(std::move(other.slabs))
+        , free_list(std::exchange(other.free_list, nullptr))
+        , next_unused(std::exchange(other.next_unused, nullptr))
+        , slab_end(std::exchange(other.slab_end, nullptr))
+        , reserved(std::exchange(other.reserved, 0))
+        , next_slab_size(std::exchange(other.next_slab_size, min_slab_size))
+        , allocated(std::move(other.allocated))
+    {
+        other.slabs.clear();
+    }
+
+    /**
+     * @brief the slabs of the allocator are returned to the system (as in the destructor)
+     *  and the slabs of the other allocator are taken
+     */
+    SlabAllocator& operator=(SlabAllocator<Type, TrackingPolicy>&& other) noexcept
+    {
+        if(this != &other)
+        {
+            slabs = std::move(other.slabs);
+            other.slabs.clear();
+
+            free_list = std::exchange(other.free_list, nullptr);
+            next_unused = std::exchange(other.next_unused, nullptr);
+            slab_end = std::exchange(other.slab_end, nullptr);
+            reserved = std::exchange(other.reserved, 0);
+            next_slab_size = std::exchange(other.next_slab_size, min_slab_size);
+            allocated = std::move(other.allocated);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief constructs an object in a free slot using a specific constructor with parameters
+     * - the arguments of the constructor are passed using perfect forwarding
+     * - if the constructor throws the slot is returned to the free list
+     * @param args - the parmeters of the constructor
+     */
+    template <class... Args>
+    Type* allocate(Args&&... args)
+    {
+        Slot* slot = get_free_slot();
+        Type* temp;
+
+        try
+        {
+            temp = ::new (static_cast<void*>(slot->storage)) Type(std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            put_free_slot(slot);
+            throw;
+        }
+
+        allocated.add(temp);
+
+        return temp;
+    }
+
+    /**
+     * @brief makes sure that the next count allocations take adjacent slots without requesting more memory,
+     *  if the current slab is too small they are taken from one new slab of exactly count objects
+     * - the reserved slots are handed out before the free list, the free list is used again after them
+     * - the unused slots of the current slab are moved to the free list, so they aren't lost
+     */
+    void reserve(size_t count)
+    {
+        if(size_t(slab_end - next_unused) < count)
+        {
+            while(next_unused != slab_end)
+                put_free_slot(next_unused++);
+
+            add_slab(count);
+        }
+
+        reserved = count;
+    }
+
+    /**
+     * @brief takes the slabs and the objects of the other allocator, which is left empty
+     * - the slabs aren't copied, so the objects keep their addresses - allocators filled by different threads
+     *   can be merged into one in O(slabs + free slots)
+     * - the unused slots of the current slab are moved to the free list, the current slab of the other allocator
+     *   becomes the current slab
+     */
+    void merge(SlabAllocator<Type, TrackingPolicy>&& other)
+    {
+        if(this == &other)
+            return;
+
+        slabs.reserve(slabs.size() + other.slabs.size());
+
+        while(next_unused != slab_end)
+            put_free_slot(next_unused++);
+
+        reserved = 0;
+
+        while(other.free_list)
+            put_free_slot(std::exchange(other.free_list, other.free_list->next));
+
+        for(Slab& slab : other.slabs)
+            slabs.push_back(std::move(slab));
+
+        if(!other.slabs.empty())
+        {
+            next_unused = other.next_unused;
+            slab_end = other.slab_end;
+            reserved = other.reserved;
+        }
+
+        next_slab_size = std::max(next_slab_size, other.next_slab_size);
+        allocated.merge(std::move(other.allocated));
+
+        other.slabs.clear();
+        other.next_unused = nullptr;
+        other.slab_end = nullptr;
+        other.reserved = 0;
+        other.next_slab_size = min_slab_size;
+    }
+
+    /**
+     * @brief destroys the object and pushes its slot in the free list
+     */
+    void deallocate(Type* ptr)
+    {
+        if(!ptr)
+            throw std::invalid_argument("ptr is not allocated");
+
+        allocated.remove(ptr);
+        ptr->~Type();
+        put_free_slot(reinterpret_cast<Slot*>(ptr));
+    }
+
+    /**
+     * @brief destroys all live objects and returns the memory of every slab at once
+     * - objects of trivially destructible types aren't visited at all
+     */
+    void deallocate_all()
+    {
+        if constexpr (!std::is_trivially_destructible_v<Type>)
+            destroy_live_objects();
+
+        slabs.clear();
+        free_list = nullptr;
+        next_unused = nullptr;
+        slab_end = nullptr;
+        reserved = 0;
+        next_slab_size = min_slab_size;
+        allocated.clear();
+    }
+
+    bool is_allocated(Type* ptr) const
+    {
+        return allocated.contains(ptr);
+    }
+
+    /**
+     * @brief the number of live objects, O(1) - allocators that don't track their objects have no size
+     */
+    size_t size() const
+        requires (!std::same_as<TrackingPolicy, Untracked>)
+    {
+        return allocated.size();
+    }
+};
+
+#endif
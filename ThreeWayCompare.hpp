@@ -0,0 +1,58 @@
+#ifndef _THREE_WAY_COMPARE_
+#define _THREE_WAY_COMPARE_
+
+#include <compare>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
+/**
+ * @brief compares two elements with a single call whenever possible, so the tree needs one comparison per level:
+ * - comparators that return an ordering (std::compare_three_way or a custom one) are called once
+ * - std::less is replaced with operator<=> if the type has a weak (or strong) ordering
+ * - any other comparator is called once for smaller elements and twice otherwise
+ */
+template <class Type, class Compare>
+class ThreeWayCompare{
+private:
+    static constexpr bool returns_ordering =
+        std::is_convertible_v<std::invoke_result_t<const Compare&, const Type&, const Type&>, std::weak_ordering>;
+
+    static constexpr bool uses_spaceship =
+        (std::is_same_v<Compare, std::less<Type>> || std::is_same_v<Compare, std::less<>>)
+        && std::three_way_comparable<Type, std::weak_ordering>;
+
+    [[no_unique_address]] Compare comp;
+
+public:
+    ThreeWayCompare() = default;
+
+    explicit ThreeWayCompare(const Compare& comp)
+        : comp(comp)
+    { }
+
+    std::weak_ordering operator()(const Type& lhs, const Type& rhs) const
+    {
+        if constexpr (returns_ordering)
+            return comp(lhs, rhs);
+        else if constexpr (uses_spaceship)
+            return lhs <=> rhs;
+        else
+        {
+            if(comp(lhs, rhs))
+                return std::weak_ordering::less;
+
+            if(comp(rhs, lhs))
+                return std::weak_ordering::greater;
+
+            return std::weak_ordering::equivalent;
+        }
+    }
+
+    const Compare& get_comparator() const
+    {
+        return comp;
+    }
+};
+
+#endif
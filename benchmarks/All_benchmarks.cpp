@@ -0,0 +1,27 @@
+#include <cstring>
+
+#include "SlabAllocator_benchmarks.cpp"
+#include "RBTreeMemoryManager_benchmarks.cpp"
+#include "Node_benchmarks.cpp"
+#include "RBTree_benchmarks.cpp"
+#include "IntervalTree_benchmarks.cpp"
+
+/**
+ * @brief runs every benchmark group, or only the groups whose name contains the first argument
+ */
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    struct { const char* name; void (*run)(); } groups[] = {
+        {"slab_allocator", run_slab_allocator_benchmarks},
+        {"memory_manager", run_memory_manager_benchmarks},
+        {"node", run_node_benchmarks},
+        {"rbtree", run_rbtree_benchmarks},
+        {"interval_tree", run_interval_tree_benchmarks},
+    };
+
+    for(const auto& group : groups)
+        if(std::strstr(group.name, filter))
+            group.run();
+}
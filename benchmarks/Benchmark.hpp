@@ -0,0 +1,100 @@
+#ifndef _BENCHMARK_
+#define _BENCHMARK_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief counts the calls of the global operator new, so benchmarks can report heap traffic
+ * - the counter is atomic because the parallel benchmarks allocate from many threads
+ * - the replacements are never inlined, as if they were linked from their own translation unit,
+ *   so the compiler doesn't pair the malloc of a new expression with the free of another delete expression
+ */
+std::atomic<size_t> heap_allocations = 0;
+
+[[gnu::noinline]] void* operator new(size_t size)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if(void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void* operator new(size_t size, std::align_val_t alignment)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    size_t align = static_cast<size_t>(alignment);
+
+    if(void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * @brief runs the function once and returns the elapsed time in milliseconds
+ */
+template <class Function>
+double measure_ms(Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void report(const char* name, size_t operations, double ms)
+{
+    std::printf("%-56s %12zu ops %10.2f ms %9.2f ns/op\n", name, operations, ms, ms * 1e6 / operations);
+}
+
+std::vector<int> shuffled_keys(size_t count, unsigned seed = 42)
+{
+    std::vector<int> keys(count);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+
+    return keys;
+}
+
+/**
+ * @brief keeps the compiler from optimizing away a computed value
+ */
+template <class Type>
+void do_not_optimize(const Type& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
@@ -0,0 +1,66 @@
+#include "Benchmark.hpp"
+#include "../IntervalTree.hpp"
+
+/**
+ * @brief random reservations of up to 100 units in a range of 1M intervals * 100 units
+ */
+std::vector<Interval<long long>> random_intervals(size_t count, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<long long> start(0, count * 100);
+    std::uniform_int_distribution<long long> length(1, 100);
+
+    std::vector<Interval<long long>> intervals(count);
+
+    for(Interval<long long>& interval : intervals)
+    {
+        interval.start = start(generator);
+        interval.end = interval.start + length(generator);
+    }
+
+    return intervals;
+}
+
+void run_interval_tree_benchmarks()
+{
+    constexpr size_t count = 1000000;
+    constexpr size_t queries = 100000;
+    constexpr size_t scanned_queries = 100;
+
+    std::vector<Interval<long long>> intervals = random_intervals(count, 42);
+    std::vector<Interval<long long>> query_intervals = random_intervals(queries, 7);
+
+    IntervalTree<long long> tree;
+
+    double ms = measure_ms([&]{
+        for(const Interval<long long>& interval : intervals)
+            tree.try_insert(interval);
+    });
+
+    report("IntervalTree insert", count, ms);
+
+    size_t found = 0;
+
+    ms = measure_ms([&]{
+        for(const Interval<long long>& query : query_intervals)
+            found += tree.any_overlap(query);
+    });
+
+    report("IntervalTree any_overlap", queries, ms);
+
+    ms = measure_ms([&]{
+        for(const Interval<long long>& query : query_intervals)
+            tree.all_overlaps(query, [&](const Interval<long long>&){ ++found; });
+    });
+
+    report("IntervalTree all_overlaps", queries, ms);
+
+    ms = measure_ms([&]{
+        for(size_t i = 0; i < scanned_queries; ++i)
+            for(const Interval<long long>& interval : intervals)
+                found += interval.overlaps(query_intervals[i]);
+    });
+
+    report("linear scan for overlaps", scanned_queries, ms);
+    do_not_optimize(found);
+}
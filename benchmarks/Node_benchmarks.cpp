@@ -0,0 +1,36 @@
+#include "Benchmark.hpp"
+#include "../RBTree.hpp"
+#include "../SlabAllocator.hpp"
+
+/**
+ * @brief builds a tree of the given node type in slabs and measures random lookups
+ */
+template <class NodeType>
+void node_layout_benchmark(const char* name, const std::vector<int>& keys, const std::vector<int>& queries)
+{
+    RBTree<int, SlabAllocator<NodeType>> tree;
+
+    for(int key : keys)
+        tree.insert(key);
+
+    std::printf("%-56s %12zu nodes %7zu B/node %8.1f MB\n", name, keys.size(), sizeof(NodeType),
+                sizeof(NodeType) * (keys.size() + 1) / 1e6);
+
+    size_t found = 0;
+    double ms = measure_ms([&]{
+        for(int query : queries)
+            found += tree.exists(query);
+    });
+
+    do_not_optimize(found);
+    report(name, queries.size(), ms);
+}
+
+void run_node_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(10000000);
+    std::vector<int> queries = shuffled_keys(10000000, 7);
+
+    node_layout_benchmark<Node<int>>("Node<int> exists", keys, queries);
+    node_layout_benchmark<CompactNode<int>>("CompactNode<int> exists", keys, queries);
+}
@@ -0,0 +1,120 @@
+#include "Benchmark.hpp"
+#include "../RBTree.hpp"
+#include "../SlabAllocator.hpp"
+
+#include <memory_resource>
+#include <string>
+
+/**
+ * @brief inserts every key in a tree and then erases all of them
+ */
+template <class Tree>
+void insert_erase_benchmark(const char* name, Tree& tree, const std::vector<int>& keys)
+{
+    double ms = measure_ms([&]{
+        for(int key : keys)
+            tree.insert(key);
+
+        for(int key : keys)
+            tree.erase(key);
+    });
+
+    report(name, keys.size() * 2, ms);
+}
+
+/**
+ * @brief fills a tree with the given keys and measures only clear()
+ */
+template <class Tree, class Key>
+void clear_benchmark(const char* name, const std::vector<Key>& keys)
+{
+    Tree tree;
+
+    for(const Key& key : keys)
+        tree.insert(key);
+
+    double ms = measure_ms([&]{
+        tree.clear();
+    });
+
+    report(name, keys.size(), ms);
+}
+
+/**
+ * @brief keeps a sliding window of keys - every new key is inserted and the oldest one is erased
+ */
+template <class Tree, class Key>
+void churn_benchmark(const char* name, const std::vector<Key>& keys, size_t window, size_t recycle_limit)
+{
+    Tree tree;
+    tree.set_recycle_limit(recycle_limit);
+
+    for(size_t i = 0; i < window; ++i)
+        tree.insert(keys[i]);
+
+    size_t heap_allocations_before = heap_allocations.load();
+
+    double ms = measure_ms([&]{
+        for(size_t i = window; i < keys.size(); ++i)
+        {
+            tree.erase(keys[i - window]);
+            tree.insert(keys[i]);
+        }
+    });
+
+    report(name, (keys.size() - window) * 2, ms);
+    std::printf("%-56s %12zu heap allocations\n", name, heap_allocations.load() - heap_allocations_before);
+}
+
+void run_memory_manager_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(1000000);
+
+    {
+        RBTree<int, MyAllocator<Node<int>, Tracked>> tree;
+        insert_erase_benchmark("RBTree<int, MyAllocator<Tracked>> insert/erase", tree, keys);
+    }
+    {
+        RBTree<int, MyAllocator<Node<int>, CountOnly>> tree;
+        insert_erase_benchmark("RBTree<int, MyAllocator<CountOnly>> insert/erase", tree, keys);
+    }
+    {
+        RBTree<int, MyAllocator<Node<int>, Untracked>> tree;
+        insert_erase_benchmark("RBTree<int, MyAllocator<Untracked>> insert/erase", tree, keys);
+    }
+    {
+        RBTree<int, SlabAllocator<Node<int>>> tree;
+        insert_erase_benchmark("RBTree<int, SlabAllocator> insert/erase", tree, keys);
+    }
+    {
+        RBTree<int, std::allocator<int>> tree;
+        insert_erase_benchmark("RBTree<int, std::allocator> insert/erase", tree, keys);
+    }
+    {
+        std::pmr::unsynchronized_pool_resource resource;
+        RBTree<int, std::pmr::polymorphic_allocator<int>> tree(&resource);
+        insert_erase_benchmark("RBTree<int, pmr pool> insert/erase", tree, keys);
+    }
+
+    std::vector<int> churn_keys = shuffled_keys(1100000);
+    std::vector<std::string> churn_strings;
+
+    for(int key : churn_keys)
+        churn_strings.push_back(std::string(24, 'k') + std::to_string(key));
+
+    churn_benchmark<RBTree<int>>("RBTree<int> sliding window churn", churn_keys, 100000, 0);
+    churn_benchmark<RBTree<int>>("RBTree<int> sliding window churn, recycling", churn_keys, 100000, 64);
+    churn_benchmark<RBTree<std::string>>("RBTree<string> sliding window churn", churn_strings, 100000, 0);
+    churn_benchmark<RBTree<std::string>>("RBTree<string> sliding window churn, recycling", churn_strings, 100000, 64);
+
+    std::vector<int> clear_keys = shuffled_keys(4000000);
+    std::vector<std::string> string_keys;
+
+    for(size_t i = 0; i < 1000000; ++i)
+        string_keys.push_back(std::string(24, 'k') + std::to_string(clear_keys[i]));
+
+    clear_benchmark<RBTree<int>>("RBTree<int, MyAllocator> clear", clear_keys);
+    clear_benchmark<RBTree<int, SlabAllocator<Node<int>>>>("RBTree<int, SlabAllocator> clear (region release)", clear_keys);
+    clear_benchmark<RBTree<std::string>>("RBTree<string, MyAllocator> clear", string_keys);
+    clear_benchmark<RBTree<std::string, SlabAllocator<Node<std::string>>>>("RBTree<string, SlabAllocator> clear (slab sweep)", string_keys);
+}
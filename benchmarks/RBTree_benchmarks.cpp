@@ -0,0 +1,778 @@
+#include "Benchmark.hpp"
+#include "../RBTree.hpp"
+#include "../SlabAllocator.hpp"
+
+#include <compare>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+std::vector<std::string> string_keys(const std::vector<int>& keys)
+{
+    std::vector<std::string> strings;
+    strings.reserve(keys.size());
+
+    for(int key : keys)
+        strings.push_back(std::string(40, 'k') + std::to_string(key));
+
+    return strings;
+}
+
+void insert_benchmarks(const std::vector<int>& keys)
+{
+    std::vector<std::string> strings = string_keys(keys);
+
+    {
+        RBTree<std::string> tree;
+
+        double ms = measure_ms([&]{
+            for(const std::string& key : strings)
+                tree.insert(key);
+        });
+
+        report("RBTree<string> insert(const Type&)", strings.size(), ms);
+    }
+    {
+        RBTree<std::string> tree;
+        std::vector<std::string> moved = strings;
+
+        double ms = measure_ms([&]{
+            for(std::string& key : moved)
+                tree.insert(std::move(key));
+        });
+
+        report("RBTree<string> insert(Type&&)", strings.size(), ms);
+    }
+    {
+        RBTree<std::string> tree;
+
+        double ms = measure_ms([&]{
+            for(const std::string& key : strings)
+                tree.emplace(key.data(), key.size());
+        });
+
+        report("RBTree<string> emplace(const char*, size_t)", strings.size(), ms);
+    }
+}
+
+/**
+ * @brief moves every element of a staging tree to a live tree
+ */
+void transfer_benchmarks(const std::vector<int>& keys)
+{
+    std::vector<std::string> strings = string_keys(keys);
+
+    {
+        RBTree<std::string> staging, live;
+
+        for(const std::string& key : strings)
+            staging.insert(key);
+
+        double ms = measure_ms([&]{
+            for(const std::string& key : strings)
+            {
+                live.insert(key);
+                staging.erase(key);
+            }
+        });
+
+        report("RBTree<string> transfer with erase + insert", strings.size(), ms);
+    }
+    {
+        RBTree<std::string> staging, live;
+
+        for(const std::string& key : strings)
+            staging.insert(key);
+
+        double ms = measure_ms([&]{
+            for(const std::string& key : strings)
+                live.insert(staging.extract(key));
+        });
+
+        report("RBTree<string> transfer with extract + insert(handle)", strings.size(), ms);
+    }
+}
+
+/**
+ * @brief comparators that count their calls - a bool comparator (called up to twice per level)
+ *  and a comparator returning an ordering (called once per level)
+ */
+size_t comparisons = 0;
+
+struct CountingLess{
+    bool operator()(const std::string& lhs, const std::string& rhs) const
+    {
+        ++comparisons;
+        return lhs < rhs;
+    }
+};
+
+struct CountingThreeWay{
+    std::weak_ordering operator()(const std::string& lhs, const std::string& rhs) const
+    {
+        ++comparisons;
+        return lhs <=> rhs;
+    }
+};
+
+template <class Compare>
+void comparison_benchmark(const char* name, const std::vector<std::string>& strings)
+{
+    RBTree<std::string, MyAllocator<Node<std::string>>, Compare> tree;
+    comparisons = 0;
+
+    double ms = measure_ms([&]{
+        for(const std::string& key : strings)
+            tree.insert(key);
+
+        for(const std::string& key : strings)
+            do_not_optimize(tree.exists(key));
+    });
+
+    report(name, 2 * strings.size(), ms);
+    std::printf("%-56s %12zu comparisons %6.2f per op\n", "", comparisons, double(comparisons) / (2 * strings.size()));
+}
+
+void comparison_benchmarks(const std::vector<int>& keys)
+{
+    std::vector<std::string> strings = string_keys(keys);
+
+    comparison_benchmark<CountingLess>("RBTree<string> insert + exists, bool comparator", strings);
+    comparison_benchmark<CountingThreeWay>("RBTree<string> insert + exists, three-way comparator", strings);
+}
+
+/**
+ * @brief inserts keys of which about 30% are duplicates, reporting them with exceptions and with try_insert
+ */
+void duplicate_benchmarks(const std::vector<int>& keys)
+{
+    std::vector<int> with_duplicates = keys;
+
+    for(size_t i = 0; i < keys.size() * 3 / 10; ++i)
+        with_duplicates[i] = keys[keys.size() - 1 - i];
+
+    std::vector<std::string> strings = string_keys(with_duplicates);
+
+    {
+        RBTree<std::string> tree;
+        size_t duplicates = 0;
+
+        double ms = measure_ms([&]{
+            for(const std::string& key : strings)
+            {
+                try
+                {
+                    tree.insert(key);
+                }
+                catch(const std::invalid_argument&)
+                {
+                    ++duplicates;
+                }
+            }
+        });
+
+        report("RBTree<string> insert, 30% duplicates throw", strings.size(), ms);
+        do_not_optimize(duplicates);
+    }
+    {
+        RBTree<std::string> tree;
+        size_t duplicates = 0;
+
+        double ms = measure_ms([&]{
+            for(const std::string& key : strings)
+                if(!tree.try_insert(key).second)
+                    ++duplicates;
+        });
+
+        report("RBTree<string> try_insert, 30% duplicates", strings.size(), ms);
+        do_not_optimize(duplicates);
+    }
+}
+
+/**
+ * @brief sums all elements with an in-order scan of the tree and of std::set,
+ *  the heap allocations during the scan are reported as well
+ */
+void scan_benchmarks(const std::vector<int>& keys)
+{
+    constexpr int scans = 10;
+
+    {
+        RBTree<int> tree;
+
+        for(int key : keys)
+            tree.insert(key);
+
+        long long sum = 0;
+        size_t allocations = heap_allocations.load();
+
+        double ms = measure_ms([&]{
+            for(int i = 0; i < scans; ++i)
+                for(int value : tree)
+                    sum += value;
+        });
+
+        report("RBTree<int> in-order scan", scans * keys.size(), ms);
+        std::printf("%-56s %12zu heap allocations\n", "", heap_allocations.load() - allocations);
+        do_not_optimize(sum);
+    }
+    {
+        std::set<int> set(keys.begin(), keys.end());
+
+        long long sum = 0;
+
+        double ms = measure_ms([&]{
+            for(int i = 0; i < scans; ++i)
+                for(int value : set)
+                    sum += value;
+        });
+
+        report("std::set<int> in-order scan", scans * keys.size(), ms);
+        do_not_optimize(sum);
+    }
+}
+
+/**
+ * @brief sums random ranges of about 1000 elements with range_aggregate and with a scan of the range
+ */
+void aggregate_benchmarks(const std::vector<int>& keys)
+{
+    constexpr size_t queries = 100000;
+
+    RBTree<long long, MyAllocator<AugmentedNode<long long, SumAugmentation<long long>>>> tree;
+
+    for(int key : keys)
+        tree.insert(key);
+
+    std::vector<int> lows = shuffled_keys(queries, 7);
+    long long sum = 0;
+
+    double ms = measure_ms([&]{
+        for(int low : lows)
+            sum += tree.range_aggregate(low, low + 1000);
+    });
+
+    report("AugmentedNode range_aggregate, 1000 elements", queries, ms);
+
+    ms = measure_ms([&]{
+        for(int low : lows)
+            tree.for_each_in_range(low, low + 1000, [&](long long value){ sum += value; });
+    });
+
+    report("AugmentedNode scan of the range, 1000 elements", queries, ms);
+    do_not_optimize(sum);
+}
+
+/**
+ * @brief random lookups in a tree much larger than the last level cache, one by one and in batches
+ */
+void batch_lookup_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(4000000);
+    std::vector<int> queries = shuffled_keys(4000000, 7);
+
+    RBTree<int> tree;
+
+    for(int key : keys)
+        tree.insert(key);
+
+    std::unique_ptr<bool[]> results(new bool[queries.size()]);
+
+    double ms = measure_ms([&]{
+        for(size_t i = 0; i < queries.size(); ++i)
+            results[i] = tree.exists(queries[i]);
+    });
+
+    report("RBTree<int> 4M nodes, loop of exists", queries.size(), ms);
+    do_not_optimize(results[0]);
+
+    ms = measure_ms([&]{
+        tree.exists_batch(queries, std::span<bool>(results.get(), queries.size()));
+    });
+
+    report("RBTree<int> 4M nodes, exists_batch", queries.size(), ms);
+    do_not_optimize(results[0]);
+}
+
+/**
+ * @brief sorted inserts and lookups (monotonic timestamps) from the root and through hints
+ */
+void finger_benchmarks()
+{
+    constexpr int count = 1000000;
+
+    {
+        RBTree<long long> tree;
+
+        double ms = measure_ms([&]{
+            for(int i = 0; i < count; ++i)
+                tree.insert(i * 3LL);
+        });
+
+        report("RBTree<long long> sorted insert(value)", count, ms);
+    }
+
+    RBTree<long long> tree;
+    RBTree<long long>::const_iterator hint = tree.end();
+
+    double ms = measure_ms([&]{
+        for(int i = 0; i < count; ++i)
+            hint = tree.insert(hint, i * 3LL);
+    });
+
+    report("RBTree<long long> sorted insert(hint, value)", count, ms);
+
+    size_t found = 0;
+
+    ms = measure_ms([&]{
+        for(int i = 0; i < 3 * count; ++i)
+            found += tree.exists(i);
+    });
+
+    report("RBTree<long long> sorted exists(value)", 3 * count, ms);
+
+    ms = measure_ms([&]{
+        RBTree<long long>::const_iterator finger = tree.end();
+
+        for(int i = 0; i < 3 * count; ++i)
+        {
+            RBTree<long long>::const_iterator result = tree.find(finger, i);
+
+            if(result != tree.end())
+            {
+                finger = result;
+                ++found;
+            }
+        }
+    });
+
+    report("RBTree<long long> sorted find(hint, value)", 3 * count, ms);
+    do_not_optimize(found);
+}
+
+/**
+ * @brief startup from a sorted snapshot of 50M keys - a loop of inserts against assign_sorted
+ */
+void bulk_build_benchmarks()
+{
+    constexpr size_t count = 50000000;
+
+    std::vector<int> keys(count);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    {
+        RBTree<int, SlabAllocator<CompactNode<int>>> tree;
+
+        double ms = measure_ms([&]{
+            for(int key : keys)
+                tree.insert(key);
+        });
+
+        report("RBTree 50M sorted keys, loop of insert", count, ms);
+    }
+    {
+        RBTree<int, SlabAllocator<CompactNode<int>>> tree;
+
+        double ms = measure_ms([&]{
+            tree.assign_sorted(keys.begin(), keys.end());
+        });
+
+        report("RBTree 50M sorted keys, assign_sorted", count, ms);
+        do_not_optimize(tree.height());
+    }
+}
+
+/**
+ * @brief hands off the upper half of a 1M tree to another tree and takes it back,
+ *  by re-inserting the elements and with split and join
+ */
+void split_join_benchmarks(const std::vector<int>& keys)
+{
+    const int middle = int(keys.size() / 2);
+
+    {
+        RBTree<int> tree, shard;
+
+        for(int key : keys)
+            tree.insert(key);
+
+        double ms = measure_ms([&]{
+            for(int key = middle; key < int(keys.size()); ++key)
+            {
+                shard.insert(key);
+                tree.erase(key);
+            }
+
+            for(int key = middle; key < int(keys.size()); ++key)
+                tree.insert(key);
+
+            shard.clear();
+        });
+
+        report("RBTree<int> hand-off of 500k elements, re-insert", 1, ms);
+    }
+    {
+        RBTree<int> tree;
+
+        for(int key : keys)
+            tree.insert(key);
+
+        double ms = measure_ms([&]{
+            auto [left, right] = std::move(tree).split(middle);
+            right.erase(middle);
+            tree = RBTree<int>::join(std::move(left), middle, std::move(right));
+        });
+
+        report("RBTree<int> hand-off of 500k elements, split + join", 1, ms);
+        do_not_optimize(tree.height());
+    }
+    {
+        RBTree<int> tree;
+
+        for(int key : keys)
+            tree.insert(key);
+
+        double ms = measure_ms([&]{
+            auto [front, rest] = std::move(tree).split(1000);
+            rest.erase(1000);
+            tree = RBTree<int>::join(std::move(front), 1000, std::move(rest));
+        });
+
+        report("RBTree<int> hand-off of 1000 front elements, split+join", 1, ms);
+        do_not_optimize(tree.height());
+    }
+}
+
+/**
+ * @brief the union of two trees with 1M random keys each, half of them shared -
+ *  inserting the elements of one tree into the other and set_union with one and with all hardware threads
+ */
+void set_operation_benchmarks()
+{
+    constexpr int count = 1000000;
+
+    std::vector<int> keys = shuffled_keys(3 * count / 2);
+    std::vector<int> first_keys(keys.begin(), keys.begin() + count);
+    std::vector<int> second_keys(keys.end() - count, keys.end());
+
+    auto build = [](const std::vector<int>& values){
+        RBTree<int> tree;
+
+        for(int value : values)
+            tree.insert(value);
+
+        return tree;
+    };
+
+    {
+        RBTree<int> first = build(first_keys), second = build(second_keys);
+
+        double ms = measure_ms([&]{
+            for(int value : second)
+                first.try_insert(value);
+
+            second.clear();
+        });
+
+        report("RBTree<int> union of 1M + 1M, loop of try_insert", count, ms);
+    }
+
+    std::vector<size_t> thread_counts = {1};
+
+    if(std::thread::hardware_concurrency() > 1)
+        thread_counts.push_back(std::thread::hardware_concurrency());
+
+    for(size_t threads : thread_counts)
+    {
+        RBTree<int> first = build(first_keys), second = build(second_keys);
+        RBTree<int> united;
+
+        double ms = measure_ms([&]{
+            united = RBTree<int>::set_union(std::move(first), std::move(second), threads);
+        });
+
+        std::string name = "RBTree<int> union of 1M + 1M, set_union, " + std::to_string(threads) + " threads";
+        report(name.c_str(), count, ms);
+        do_not_optimize(united.height());
+    }
+}
+
+/**
+ * @brief expires the oldest half of 1M timestamps with a loop of erase and with erase_range
+ */
+void erase_range_benchmarks()
+{
+    constexpr int count = 1000000;
+
+    {
+        RBTree<long long> tree;
+
+        for(int i = 0; i < count; ++i)
+            tree.insert(i * 3LL);
+
+        double ms = measure_ms([&]{
+            for(int i = 0; i < count / 2; ++i)
+                tree.erase(i * 3LL);
+        });
+
+        report("RBTree<long long> expire 500k of 1M, loop of erase", count / 2, ms);
+    }
+    {
+        RBTree<long long> tree;
+
+        for(int i = 0; i < count; ++i)
+            tree.insert(i * 3LL);
+
+        size_t erased = 0;
+
+        double ms = measure_ms([&]{
+            erased = tree.erase_range(0, count / 2 * 3LL);
+        });
+
+        report("RBTree<long long> expire 500k of 1M, erase_range", erased, ms);
+    }
+}
+
+/**
+ * @brief ingests 10 batches of 100k random keys with a loop of try_insert and with insert_batch
+ */
+void insert_batch_benchmarks(const std::vector<int>& keys)
+{
+    constexpr size_t batch_size = 100000;
+
+    {
+        RBTree<int> tree;
+
+        double ms = measure_ms([&]{
+            for(int key : keys)
+                tree.try_insert(key);
+        });
+
+        report("RBTree<int> 1M keys in batches of 100k, loop of try_insert", keys.size(), ms);
+    }
+    {
+        RBTree<int> tree;
+        std::vector<int> batches = keys;
+        size_t inserted = 0;
+
+        double ms = measure_ms([&]{
+            for(size_t start = 0; start < batches.size(); start += batch_size)
+                inserted += tree.insert_batch(std::span<int>(batches).subspan(start, std::min(batch_size, batches.size() - start)));
+        });
+
+        report("RBTree<int> 1M keys in batches of 100k, insert_batch", keys.size(), ms);
+        do_not_optimize(inserted);
+    }
+}
+
+/**
+ * @brief cold start from an unsorted dump of 10M keys - a loop of insert against build_parallel
+ *  with one and with all hardware threads
+ */
+void parallel_build_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(10000000);
+
+    {
+        RBTree<int, SlabAllocator<CompactNode<int>>> tree;
+
+        double ms = measure_ms([&]{
+            for(int key : keys)
+                tree.insert(key);
+        });
+
+        report("RBTree 10M unsorted keys, loop of insert", keys.size(), ms);
+    }
+
+    std::vector<size_t> thread_counts = {1};
+
+    if(std::thread::hardware_concurrency() > 1)
+        thread_counts.push_back(std::thread::hardware_concurrency());
+
+    for(size_t threads : thread_counts)
+    {
+        RBTree<int, SlabAllocator<CompactNode<int>>> tree;
+
+        double ms = measure_ms([&]{
+            tree.build_parallel(keys.begin(), keys.end(), threads);
+        });
+
+        std::string name = "RBTree 10M unsorted keys, build_parallel, " + std::to_string(threads) + " threads";
+        report(name.c_str(), keys.size(), ms);
+        do_not_optimize(tree.height());
+    }
+}
+
+/**
+ * @brief a tree that also has the recursive copy, height and destruction the tree had before they were made
+ *  iterative, kept as a reference so both versions can be timed on the same nodes
+ */
+template <class Allocator>
+class RecursiveReferenceTree : public RBTree<int, Allocator>{
+private:
+    using node_ptr = node_t<int, Allocator>*;
+
+    using RBTreeMemoryManager<int, Allocator> :: root;
+    using RBTreeMemoryManager<int, Allocator> :: null_node;
+    using RBTreeMemoryManager<int, Allocator> :: alloc;
+    using RBTreeMemoryManager<int, Allocator> :: tree_black_height;
+
+    node_ptr copy_helper(node_ptr parent, node_ptr other_node, const node_ptr& other_null_node)
+    {
+        if(other_node == other_null_node)
+            return null_node;
+
+        node_ptr current = alloc.allocate(other_node);
+        current->set_parent(parent);
+
+        current->left = copy_helper(current, other_node->left, other_null_node);
+        current->right = copy_helper(current, other_node->right, other_null_node);
+
+        return current;
+    }
+
+    void calculate_height(node_ptr node, size_t& height, size_t curr_height = 0) const
+    {
+        if(node == null_node)
+        {
+            if(curr_height > height)
+                height = curr_height;
+
+            return;
+        }
+
+        calculate_height(node->left, height, curr_height + 1);
+        calculate_height(node->right, height, curr_height + 1);
+    }
+
+    void delete_not_null_nodes(node_ptr node)
+    {
+        if(node == null_node)
+            return;
+
+        delete_not_null_nodes(node->left);
+        delete_not_null_nodes(node->right);
+
+        alloc.deallocate(node);
+    }
+
+public:
+    /**
+     * @brief copies the nodes of the other tree into this empty tree
+     */
+    void copy_recursive(const RecursiveReferenceTree& other)
+    {
+        root = copy_helper(null_node, other.root, other.null_node);
+        tree_black_height = other.tree_black_height;
+    }
+
+    size_t height_recursive() const
+    {
+        size_t height = 0;
+
+        calculate_height(root, height);
+
+        return height;
+    }
+
+    void destroy_recursive()
+    {
+        delete_not_null_nodes(root);
+        root = null_node;
+        tree_black_height = 0;
+    }
+};
+
+/**
+ * @brief copies, measures the height of and destroys a tree of 10M nodes, with new for every node and with slabs,
+ *  with the recursive reference and with the iterative versions of the tree
+ * - both copies are alive at once, so neither is allocated in the memory the other has freed
+ * - slab allocated trees are destroyed by releasing the slabs in both versions, so only the iterative one is timed
+ */
+template <class Allocator>
+void copy_destroy_benchmark(const char* name, const std::vector<int>& keys)
+{
+    RecursiveReferenceTree<Allocator> tree;
+
+    for(int key : keys)
+        tree.insert(key);
+
+    RecursiveReferenceTree<Allocator> reference;
+    std::optional<RBTree<int, Allocator>> copy;
+
+    double ms = measure_ms([&]{
+        reference.copy_recursive(tree);
+    });
+
+    report((std::string(name) + " copy, recursive").c_str(), keys.size(), ms);
+
+    ms = measure_ms([&]{
+        copy.emplace(tree);
+    });
+
+    report((std::string(name) + " copy").c_str(), keys.size(), ms);
+
+    size_t height = 0;
+
+    ms = measure_ms([&]{
+        height = reference.height_recursive();
+    });
+
+    report((std::string(name) + " height(), recursive").c_str(), keys.size(), ms);
+    do_not_optimize(height);
+
+    ms = measure_ms([&]{
+        height = copy->height();
+    });
+
+    report((std::string(name) + " height()").c_str(), keys.size(), ms);
+    do_not_optimize(height);
+
+    if constexpr (!has_region_release<node_allocator_t<int, Allocator>>::value)
+    {
+        ms = measure_ms([&]{
+            reference.destroy_recursive();
+        });
+
+        report((std::string(name) + " destroy, recursive").c_str(), keys.size(), ms);
+    }
+
+    ms = measure_ms([&]{
+        copy.reset();
+    });
+
+    report((std::string(name) + " destroy").c_str(), keys.size(), ms);
+}
+
+void copy_destroy_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(10000000);
+
+    copy_destroy_benchmark<MyAllocator<Node<int>>>("RBTree<int> 10M nodes", keys);
+    copy_destroy_benchmark<SlabAllocator<Node<int>>>("RBTree<int> 10M nodes, SlabAllocator", keys);
+}
+
+void run_rbtree_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(1000000);
+
+    insert_benchmarks(keys);
+    transfer_benchmarks(keys);
+    comparison_benchmarks(keys);
+    duplicate_benchmarks(keys);
+    scan_benchmarks(keys);
+    aggregate_benchmarks(keys);
+    batch_lookup_benchmarks();
+    finger_benchmarks();
+    bulk_build_benchmarks();
+    split_join_benchmarks(keys);
+    set_operation_benchmarks();
+    erase_range_benchmarks();
+    insert_batch_benchmarks(keys);
+    parallel_build_benchmarks();
+    copy_destroy_benchmarks();
+}
@@ -0,0 +1,39 @@
+#include "Benchmark.hpp"
+#include "../Node.hpp"
+#include "../MyAllocator.hpp"
+#include "../SlabAllocator.hpp"
+
+/**
+ * @brief allocates a node per key and frees them in a different order,
+ *  then replays an erase/insert churn over the live nodes
+ */
+template <class Allocator>
+void allocate_deallocate_benchmark(const char* name, const std::vector<int>& keys)
+{
+    Allocator alloc;
+    std::vector<Node<int>*> nodes(keys.size());
+
+    double ms = measure_ms([&]{
+        for(size_t i = 0; i < keys.size(); ++i)
+            nodes[i] = alloc.allocate(keys[i], nullptr, nullptr);
+
+        for(size_t i = 0; i < keys.size(); i += 2)
+        {
+            alloc.deallocate(nodes[i]);
+            nodes[i] = alloc.allocate(keys[i], nullptr, nullptr);
+        }
+
+        for(size_t i = keys.size(); i-- > 0; )
+            alloc.deallocate(nodes[keys[i]]);
+    });
+
+    report(name, keys.size() * 3, ms);
+}
+
+void run_slab_allocator_benchmarks()
+{
+    std::vector<int> keys = shuffled_keys(1000000);
+
+    allocate_deallocate_benchmark<MyAllocator<Node<int>>>("MyAllocator<Node<int>> allocate/deallocate", keys);
+    allocate_deallocate_benchmark<SlabAllocator<Node<int>>>("SlabAllocator<Node<int>> allocate/deallocate", keys);
+}
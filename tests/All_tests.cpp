@@ -1,6 +1,8 @@
 #define CATCH_CONFIG_MAIN
 
 #include "MyAllocator_tests.cpp"
+#include "SlabAllocator_tests.cpp"
 #include "RBTreeMemoryManager_tests.cpp"
 #include "RBTreeFixupOperations_tests.cpp"
-#include "RBTree_tests.cpp"
\ No newline at end of file
+#include "RBTree_tests.cpp"
+#include "IntervalTree_tests.cpp"
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "catch.hpp"
+#include "RBTreeTest.hpp"
+#include "../IntervalTree.hpp"
+
+#include <vector>
+
+SCENARIO("Testing interval tree")
+{
+    GIVEN("An empty interval tree")
+    {
+        IntervalTree<int> test;
+
+        THEN("No interval should overlap")
+        {
+            REQUIRE_FALSE(test.any_overlap({0, 100}));
+        }
+    }
+
+    GIVEN("An interval tree with reservations")
+    {
+        IntervalTree<int> test;
+
+        test.insert({10, 20});
+        test.insert({15, 25});
+        test.insert({30, 40});
+        test.insert({50, 60});
+        test.insert({50, 55});
+        test.insert({5, 8});
+
+        THEN("Overlapping queries should be found")
+        {
+            REQUIRE(test.any_overlap({19, 21}));
+            REQUIRE(test.any_overlap({0, 6}));
+            REQUIRE(test.any_overlap({54, 100}));
+        }
+
+        THEN("Intervals that only touch should not overlap")
+        {
+            REQUIRE_FALSE(test.any_overlap({25, 30}));
+            REQUIRE_FALSE(test.any_overlap({8, 10}));
+            REQUIRE_FALSE(test.any_overlap({60, 70}));
+        }
+
+        THEN("all_overlaps should visit every overlapping interval in order")
+        {
+            std::vector<Interval<int>> found;
+            test.all_overlaps({18, 52}, [&](const Interval<int>& interval){ found.push_back(interval); });
+
+            REQUIRE(found == std::vector<Interval<int>>{{10, 20}, {15, 25}, {30, 40}, {50, 55}, {50, 60}});
+        }
+
+        WHEN("An interval is erased")
+        {
+            test.erase({15, 25});
+
+            THEN("It should no longer overlap")
+            {
+                REQUIRE_FALSE(test.any_overlap({20, 30}));
+            }
+        }
+    }
+
+    GIVEN("An interval tree with many random intervals")
+    {
+        RBTreeTest<Interval<int>, MyAllocator<IntervalNode<int>>> test;
+        std::vector<Interval<int>> intervals;
+
+        for(int i = 0; i < 500; ++i)
+        {
+            Interval<int> interval{i * 7919 % 1000, i * 7919 % 1000 + i % 17 + 1};
+            intervals.push_back(interval);
+            test.insert(interval);
+        }
+
+        for(int i = 0; i < 500; i += 3)
+            test.erase(intervals[i]);
+
+        THEN("The max ends should be valid")
+        {
+            CHECK(is_valid(test));
+            CHECK(valid_summaries(test.get_root(), test.get_null_node()));
+        }
+
+        THEN("The queries should match a linear scan")
+        {
+            IntervalTree<int> queries;
+
+            for(int i = 0; i < 500; ++i)
+                if(i % 3 != 0)
+                    queries.insert(intervals[i]);
+
+            for(int start = -5; start < 1020; start += 11)
+            {
+                Interval<int> query{start, start + 7};
+                size_t expected = 0;
+
+                for(int i = 0; i < 500; ++i)
+                    if(i % 3 != 0 && intervals[i].overlaps(query))
+                        ++expected;
+
+                size_t found = 0;
+                queries.all_overlaps(query, [&](const Interval<int>& interval){
+                    REQUIRE(interval.overlaps(query));
+                    ++found;
+                });
+
+                REQUIRE(found == expected);
+                REQUIRE(queries.any_overlap(query) == (expected > 0));
+            }
+        }
+    }
+}
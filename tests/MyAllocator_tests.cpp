@@ -5,7 +5,7 @@ SCENARIO("Testing allocator behavior")
 {
     GIVEN("An empty allocator")
     {
-       MyAllocator<int> alloc;
+       MyAllocator<int, Tracked> alloc;
    
         THEN("The size of allocated elements should be zero")
         {
@@ -54,7 +54,7 @@ SCENARIO("Testing allocator behavior")
 
     GIVEN("Given a non-empty allocator")
     {
-        MyAllocator<int> alloc;
+        MyAllocator<int, Tracked> alloc;
 
         int* fst_elem = alloc.allocate();
         int* snd_elem = alloc.allocate(3);
@@ -107,7 +107,7 @@ SCENARIO("Testing allocator behavior")
 
     GIVEN("Given a non-empty allocator")
     {
-        MyAllocator<int> alloc;
+        MyAllocator<int, Tracked> alloc;
 
         int* fst_elem = alloc.allocate();
         int* snd_elem = alloc.allocate(3);
@@ -158,4 +158,53 @@ SCENARIO("Testing allocator behavior")
             alloc.deallocate(trd_elem);
         }
     }
-}
\ No newline at end of file
+}
+SCENARIO("Testing allocator tracking policies")
+{
+    GIVEN("An allocator that only counts its elements")
+    {
+        MyAllocator<int, CountOnly> alloc;
+
+        int* fst_elem = alloc.allocate(1);
+        int* snd_elem = alloc.allocate(2);
+
+        THEN("Size should be valid")
+        {
+            REQUIRE(alloc.size() == 2);
+        }
+
+        THEN("The allocator shouldn't keep a pointer registry")
+        {
+            CHECK(sizeof(alloc) == sizeof(size_t));
+        }
+
+        WHEN("An element is deallocated")
+        {
+            alloc.deallocate(fst_elem);
+
+            THEN("The size should decrease")
+            {
+                REQUIRE(alloc.size() == 1);
+            }
+
+            fst_elem = alloc.allocate(1);
+        }
+
+        alloc.deallocate(fst_elem);
+        alloc.deallocate(snd_elem);
+    }
+
+    GIVEN("An allocator that doesn't track its elements")
+    {
+        MyAllocator<int, Untracked> alloc;
+
+        int* elem = alloc.allocate(4);
+
+        THEN("The element should be valid")
+        {
+            REQUIRE(*elem == 4);
+        }
+
+        alloc.deallocate(elem);
+    }
+}
@@ -1,5 +1,12 @@
 #include "catch.hpp"
 #include "RBTreeTest.hpp"
+#include "../SlabAllocator.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 SCENARIO("Testing default constructor")
 {
@@ -146,3 +153,569 @@ SCENARIO("Testing assignment operator")
     }
 }
 
+
+SCENARIO("Testing trees with different allocators")
+{
+    GIVEN("A tree that allocates its nodes from slabs")
+    {
+        RBTree<int, SlabAllocator<Node<int>>> slab_tree;
+
+        for(int i = 1; i <= 10; ++i)
+            slab_tree.insert(i);
+
+        THEN("All nodes should be allocated from the slab allocator")
+        {
+            REQUIRE(slab_tree.get_allocator().size() == 11);
+        }
+
+        WHEN("Elements are erased")
+        {
+            slab_tree.erase(3);
+            slab_tree.erase(7);
+
+            THEN("Their nodes should be deallocated")
+            {
+                REQUIRE(slab_tree.get_allocator().size() == 9);
+                CHECK_FALSE(slab_tree.exists(3));
+                CHECK(slab_tree.exists(4));
+            }
+        }
+    }
+
+    GIVEN("A tree with a standard allocator")
+    {
+        RBTree<int, std::allocator<int>> std_tree;
+
+        for(int i = 1; i <= 10; ++i)
+            std_tree.insert(i);
+
+        THEN("The allocator should be rebound to the node type")
+        {
+            CHECK(std::is_same_v<decltype(std_tree.get_allocator().get_allocator()), std::allocator<Node<int>>>);
+        }
+
+        THEN("The number of allocated nodes should be counted")
+        {
+            REQUIRE(std_tree.get_allocator().size() == 11);
+        }
+
+        WHEN("A copy is constructed")
+        {
+            RBTree<int, std::allocator<int>> copy_tree(std_tree);
+
+            THEN("The copy should contain the same elements")
+            {
+                REQUIRE(copy_tree.get_allocator().size() == 11);
+                REQUIRE(copy_tree.height() == std_tree.height());
+                CHECK(copy_tree.exists(10));
+            }
+        }
+    }
+
+    GIVEN("A tree with a polymorphic allocator over a monotonic buffer")
+    {
+        std::byte buffer[4096];
+        std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+        RBTree<int, std::pmr::polymorphic_allocator<int>> pmr_tree(&resource);
+
+        for(int i = 1; i <= 10; ++i)
+            pmr_tree.insert(i);
+
+        THEN("The nodes should be allocated from the buffer")
+        {
+            REQUIRE(pmr_tree.get_allocator().get_allocator().resource() == &resource);
+            REQUIRE(pmr_tree.get_allocator().size() == 11);
+        }
+
+        WHEN("Elements are erased")
+        {
+            pmr_tree.erase(5);
+
+            THEN("The tree should stay valid")
+            {
+                CHECK_FALSE(pmr_tree.exists(5));
+                REQUIRE(pmr_tree.get_allocator().size() == 10);
+            }
+        }
+
+        WHEN("A copy is constructed")
+        {
+            RBTree<int, std::pmr::polymorphic_allocator<int>> copy_tree(pmr_tree);
+
+            THEN("The copy should use the default memory resource")
+            {
+                REQUIRE(copy_tree.get_allocator().get_allocator().resource() == std::pmr::get_default_resource());
+                CHECK(copy_tree.exists(10));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing region release of slab allocated trees")
+{
+    GIVEN("A non-empty tree of strings allocated from slabs")
+    {
+        RBTree<std::string, SlabAllocator<Node<std::string>>> slab_tree;
+
+        for(int i = 0; i < 100; ++i)
+            slab_tree.insert(std::string(32, 'a') + std::to_string(i));
+
+        slab_tree.erase(std::string(32, 'a') + "50");
+
+        WHEN("The tree is cleared")
+        {
+            slab_tree.clear();
+
+            THEN("Only the null node should stay allocated")
+            {
+                REQUIRE(slab_tree.get_allocator().size() == 1);
+                CHECK(slab_tree.empty());
+                REQUIRE(slab_tree.height() == 0);
+            }
+
+            THEN("The tree should be usable again")
+            {
+                slab_tree.insert("b");
+
+                CHECK(slab_tree.exists("b"));
+                REQUIRE(slab_tree.get_allocator().size() == 2);
+            }
+        }
+
+        WHEN("A copy is assigned to another tree")
+        {
+            RBTree<std::string, SlabAllocator<Node<std::string>>> other_tree;
+            other_tree.insert("b");
+
+            other_tree = slab_tree;
+
+            THEN("The old nodes of the tree should be released")
+            {
+                REQUIRE(other_tree.get_allocator().size() == 100);
+                CHECK_FALSE(other_tree.exists("b"));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing move constructor")
+{
+    GIVEN("A non-empty tree")
+    {
+        tree test;
+        init_tree(test);
+
+        tree copy_test(test);
+        node_ptr old_root = test.get_root();
+
+        WHEN("A tree is move constructed from it")
+        {
+            tree moved_test(std::move(test));
+
+            THEN("The nodes should be taken without copying")
+            {
+                REQUIRE(moved_test.get_root() == old_root);
+                REQUIRE(moved_test.get_allocator().size() == 11);
+            }
+
+            THEN("The new tree should be equal to the old one")
+            {
+                CHECK(are_equal(moved_test, copy_test));
+            }
+
+            THEN("The moved-from tree should have no nodes")
+            {
+                REQUIRE(test.get_allocator().size() == 0);
+            }
+
+            THEN("The moved-from tree can be assigned to")
+            {
+                test = copy_test;
+
+                CHECK(are_equal(test, copy_test));
+            }
+
+            THEN("The moved-from tree can be cleared and reused")
+            {
+                test.clear();
+                test.insert(2);
+
+                REQUIRE(test.find(2) != test.end());
+                REQUIRE(test.get_allocator().size() == 2);
+                CHECK(is_valid(test));
+            }
+        }
+    }
+
+    GIVEN("A non-empty slab allocated tree")
+    {
+        RBTreeTest<int, SlabAllocator<Node<int>>> test;
+        test.insert(1);
+
+        WHEN("A tree is move constructed from it")
+        {
+            RBTreeTest<int, SlabAllocator<Node<int>>> moved_test(std::move(test));
+
+            THEN("The moved-from tree can be cleared and reused")
+            {
+                test.clear();
+                test.insert(2);
+
+                REQUIRE(test.find(2) != test.end());
+                REQUIRE(moved_test.find(1) != moved_test.end());
+                CHECK(is_valid(test));
+            }
+        }
+    }
+
+    GIVEN("A vector of trees")
+    {
+        std::vector<tree> trees(1);
+        init_tree(trees[0]);
+
+        node_ptr old_root = trees[0].get_root();
+
+        WHEN("The vector is reallocated")
+        {
+            trees.resize(100);
+
+            THEN("The trees should be moved instead of copied")
+            {
+                REQUIRE(trees[0].get_root() == old_root);
+                CHECK(trees[0].exists(10));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing move assignment operator")
+{
+    GIVEN("Two non-empty trees")
+    {
+        tree tree1, tree2;
+
+        init_tree(tree1);
+        init_tree_negative(tree2);
+
+        tree copy_tree1(tree1);
+        node_ptr old_root = tree1.get_root();
+
+        WHEN("A tree is move assigned")
+        {
+            tree2 = std::move(tree1);
+
+            THEN("The nodes should be taken without copying")
+            {
+                REQUIRE(tree2.get_root() == old_root);
+                CHECK(are_equal(tree2, copy_tree1));
+            }
+
+            THEN("The old nodes of the tree should be deallocated")
+            {
+                REQUIRE(tree2.get_allocator().size() == 11);
+                CHECK_FALSE(tree2.exists(-1));
+            }
+        }
+    }
+
+    GIVEN("Two trees with polymorphic allocators over different resources")
+    {
+        std::pmr::unsynchronized_pool_resource resource1, resource2;
+
+        RBTree<int, std::pmr::polymorphic_allocator<int>> tree1(&resource1), tree2(&resource2);
+
+        for(int i = 1; i <= 10; ++i)
+            tree1.insert(i);
+
+        WHEN("A tree is move assigned")
+        {
+            tree2 = std::move(tree1);
+
+            THEN("The nodes should be copied to the resource of the assigned tree")
+            {
+                REQUIRE(tree2.get_allocator().get_allocator().resource() == &resource2);
+                REQUIRE(tree2.get_allocator().size() == 11);
+                CHECK(tree2.exists(10));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing swap")
+{
+    GIVEN("Two non-empty trees")
+    {
+        tree tree1, tree2;
+
+        init_tree(tree1);
+        init_tree_negative(tree2);
+        tree2.insert(-11);
+
+        node_ptr root1 = tree1.get_root();
+        node_ptr root2 = tree2.get_root();
+
+        WHEN("The trees are swapped")
+        {
+            swap(tree1, tree2);
+
+            THEN("The nodes should be exchanged")
+            {
+                REQUIRE(tree1.get_root() == root2);
+                REQUIRE(tree2.get_root() == root1);
+            }
+
+            THEN("The allocators should be exchanged")
+            {
+                REQUIRE(tree1.get_allocator().size() == 12);
+                REQUIRE(tree2.get_allocator().size() == 11);
+            }
+
+            THEN("Both trees should stay usable")
+            {
+                tree1.erase(-11);
+                tree2.erase(10);
+
+                CHECK_FALSE(tree1.exists(-11));
+                CHECK_FALSE(tree2.exists(10));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing node recycling")
+{
+    GIVEN("A non-empty tree that recycles up to 2 nodes")
+    {
+        tree test;
+        init_tree(test);
+        test.set_recycle_limit(2);
+
+        WHEN("Elements are erased")
+        {
+            test.erase(1);
+            test.erase(10);
+            test.erase(5);
+
+            THEN("Only the nodes over the limit should be deallocated")
+            {
+                REQUIRE(test.get_allocator().size() == 10);
+            }
+
+            THEN("New elements should reuse the recycled nodes")
+            {
+                test.insert(11);
+                test.insert(12);
+
+                REQUIRE(test.get_allocator().size() == 10);
+                CHECK(test.exists(11));
+                CHECK(test.exists(12));
+                CHECK(is_valid(test));
+            }
+
+            THEN("Shrinking should deallocate the recycled nodes")
+            {
+                test.shrink_to_fit();
+
+                REQUIRE(test.get_allocator().size() == 8);
+            }
+
+            THEN("Lowering the limit should deallocate the extra nodes")
+            {
+                test.set_recycle_limit(1);
+
+                REQUIRE(test.get_allocator().size() == 9);
+                REQUIRE(test.get_recycle_limit() == 1);
+            }
+        }
+
+        WHEN("An element is erased and inserted again")
+        {
+            node_ptr erased_node = test.get_root()->right->right->right->right;
+
+            test.erase(10);
+            test.insert(10);
+
+            THEN("The node of the element should be reused")
+            {
+                REQUIRE(test.get_root()->right->right->right->right == erased_node);
+                REQUIRE(erased_node->left == test.get_null_node());
+                REQUIRE(erased_node->right == test.get_null_node());
+                CHECK(is_valid(test));
+            }
+        }
+
+        WHEN("An existing element is constructed in place")
+        {
+            test.erase(5);
+
+            CHECK_THROWS(test.emplace(4));
+
+            THEN("The new node should be recycled")
+            {
+                REQUIRE(test.get_allocator().size() == 11);
+                CHECK_FALSE(test.exists(5));
+
+                test.insert(5);
+
+                REQUIRE(test.get_allocator().size() == 11);
+            }
+        }
+    }
+}
+
+/**
+ * @brief an element whose copies throw once copies_left reaches 0
+ */
+struct CopyLimited{
+    static inline int copies_left = 0;
+
+    int value = 0;
+
+    CopyLimited() = default;
+    explicit CopyLimited(int value) : value(value) { }
+
+    CopyLimited(const CopyLimited& other)
+        : value(other.value)
+    {
+        if(copies_left-- == 0)
+            throw std::runtime_error("copy failed");
+    }
+
+    CopyLimited& operator=(const CopyLimited& other) = default;
+
+    auto operator<=>(const CopyLimited& other) const = default;
+};
+
+SCENARIO("Testing traversals without recursion")
+{
+    GIVEN("A slab allocated tree with many elements inserted in random order")
+    {
+        RBTreeTest<int, SlabAllocator<Node<int>>> test;
+
+        for(int i = 0; i < 5000; ++i)
+            test.insert(i * 7919 % 5000);
+
+        WHEN("A copy is constructed")
+        {
+            RBTreeTest<int, SlabAllocator<Node<int>>> copy_test(test);
+
+            THEN("The copy should be valid and have the same shape")
+            {
+                CHECK(is_valid(copy_test));
+                REQUIRE(copy_test.height() == test.height());
+                REQUIRE(copy_test.black_height() == test.black_height());
+                REQUIRE(std::equal(copy_test.begin(), copy_test.end(), test.begin(), test.end()));
+            }
+
+            THEN("The nodes of the copy should be laid out in preorder in one block")
+            {
+                std::vector<Node<int>*> preorder;
+                std::vector<Node<int>*> stack = {copy_test.get_root()};
+
+                while(!stack.empty())
+                {
+                    Node<int>* node = stack.back();
+                    stack.pop_back();
+
+                    if(node == copy_test.get_null_node())
+                        continue;
+
+                    preorder.push_back(node);
+                    stack.push_back(node->right);
+                    stack.push_back(node->left);
+                }
+
+                auto address = [&](size_t i){ return reinterpret_cast<std::uintptr_t>(preorder[i]); };
+                std::uintptr_t step = address(1) - address(0);
+
+                for(size_t i = 1; i < preorder.size(); ++i)
+                    REQUIRE(address(i) - address(i - 1) == step);
+            }
+        }
+
+        THEN("The height should be within the upper bound")
+        {
+            REQUIRE(test.height() <= test.height_upper_bound());
+            REQUIRE(test.height() >= test.black_height());
+        }
+    }
+
+    GIVEN("A slab allocated tree whose allocator doesn't count its nodes")
+    {
+        RBTreeTest<int, SlabAllocator<Node<int>, Untracked>> test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        WHEN("A copy is constructed")
+        {
+            RBTreeTest<int, SlabAllocator<Node<int>, Untracked>> copy_test(test);
+
+            THEN("The copy should be valid without reserving memory")
+            {
+                CHECK(is_valid(copy_test));
+                REQUIRE(std::equal(copy_test.begin(), copy_test.end(), test.begin(), test.end()));
+            }
+        }
+    }
+
+    GIVEN("A tree whose elements can't all be copied")
+    {
+        RBTreeTest<CopyLimited> test;
+
+        CopyLimited::copies_left = 1000000;
+
+        for(int i = 0; i < 500; ++i)
+            test.insert(CopyLimited(i * 7919 % 500));
+
+        WHEN("A copy is constructed")
+        {
+            CopyLimited::copies_left = 300;
+
+            THEN("The copy should throw without leaking the copied nodes")
+            {
+                REQUIRE_THROWS_AS(RBTreeTest<CopyLimited>(test), std::runtime_error);
+            }
+        }
+
+        WHEN("The tree is copy assigned to another tree")
+        {
+            RBTreeTest<CopyLimited> other;
+            other.insert(CopyLimited(1));
+
+            CopyLimited::copies_left = 300;
+
+            THEN("The other tree should be left empty and valid")
+            {
+                REQUIRE_THROWS_AS(other = test, std::runtime_error);
+                REQUIRE(other.empty());
+                REQUIRE(other.get_allocator().size() == 1);
+                CHECK(is_valid(other));
+            }
+        }
+
+        CopyLimited::copies_left = 0;
+    }
+
+    GIVEN("A tree whose elements are erased one by one")
+    {
+        tree test;
+
+        for(int i = 0; i < 2000; ++i)
+            test.insert(i * 7919 % 2000);
+
+        THEN("The maintained black height should stay equal to the black height of every path")
+        {
+            for(int i = 0; i < 2000; ++i)
+            {
+                test.erase(i * 7919 % 2000);
+
+                REQUIRE(is_valid(test));
+                REQUIRE(test.height() <= test.height_upper_bound());
+            }
+
+            REQUIRE(test.black_height() == 0);
+        }
+    }
+}
@@ -4,25 +4,36 @@
 #include "../Node.hpp"
 #include "../RBTree.hpp"
 
-template <class Type, class Allocator = MyAllocator<Node<Type>>>
-class RBTreeTest : public RBTree<Type, Allocator>{
+template <class Type, class Allocator = MyAllocator<Node<Type>>, class Compare = std::less<Type>>
+class RBTreeTest : public RBTree<Type, Allocator, Compare>{
 private:
     using RBTreeMemoryManager<Type, Allocator> :: root;
     using RBTreeMemoryManager<Type, Allocator> :: null_node;
 
 public:
+    using RBTree<Type, Allocator, Compare> :: RBTree;
+
+    RBTreeTest() = default;
+
+    /**
+     * @brief takes the nodes of a tree returned by the tree (split, join), so its structure can be checked
+     */
+    RBTreeTest(RBTree<Type, Allocator, Compare>&& other)
+        : RBTree<Type, Allocator, Compare>(std::move(other))
+    { }
+
     using RBTreeFixupOperations<Type, Allocator> :: rotateLeft;
     using RBTreeFixupOperations<Type, Allocator> :: rotateRight;
     using RBTreeFixupOperations<Type, Allocator> :: transplant;
 
     using RBTreeMemoryManager<Type, Allocator> :: delete_not_null_nodes;
 
-    Node<Type>* & get_root()
+    node_t<Type, Allocator>* & get_root()
     {
         return  root;
     }
 
-    Node<Type>* & get_null_node()
+    node_t<Type, Allocator>* & get_null_node()
     {
         return null_node;
     }
@@ -78,4 +89,82 @@ bool is_leaf(node_ptr& node, node_ptr& null_node)
     return node->left == null_node && node->right == null_node;
 }
 
+/**
+ * @brief checks the order (by the comparator of the tree), the parent pointers, that a red node has no red child
+ *  and that all paths have the same black height, returns the black height or -1 if the subtree isn't valid
+ */
+template <class NodePtr, class Compare>
+int valid_black_height(NodePtr node, NodePtr parent, NodePtr null_node, const Compare& compare)
+{
+    if(node == null_node)
+        return 0;
+
+    if(node->get_parent() != parent)
+        return -1;
+
+    if(node->left != null_node && !(compare(node->left->value, node->value) < 0))
+        return -1;
+
+    if(node->right != null_node && !(compare(node->value, node->right->value) < 0))
+        return -1;
+
+    if(node->is_red() && (node->left->is_red() || node->right->is_red()))
+        return -1;
+
+    int left_height = valid_black_height(node->left, node, null_node, compare);
+    int right_height = valid_black_height(node->right, node, null_node, compare);
+
+    if(left_height == -1 || left_height != right_height)
+        return -1;
+
+    return left_height + (node->is_black() ? 1 : 0);
+}
+
+/**
+ * @brief checks that every node of a tree with subtree sizes knows the size of its subtree
+ */
+template <class NodePtr>
+bool valid_sizes(NodePtr node, NodePtr null_node)
+{
+    if(node == null_node)
+        return node->size == 0;
+
+    return node->size == node->left->size + node->right->size + 1
+        && valid_sizes(node->left, null_node)
+        && valid_sizes(node->right, null_node);
+}
+
+/**
+ * @brief checks that the summary of every augmented node is the summary of its subtree
+ */
+template <class NodePtr>
+bool valid_summaries(NodePtr node, NodePtr null_node)
+{
+    using augmentation = typename std::remove_pointer_t<NodePtr> :: augmentation;
+
+    if(node == null_node)
+        return node->summary == augmentation :: identity();
+
+    auto expected = augmentation :: combine(augmentation :: combine(node->left->summary, augmentation :: lift(node->value)),
+                                            node->right->summary);
+
+    return node->summary == expected
+        && valid_summaries(node->left, null_node)
+        && valid_summaries(node->right, null_node);
+}
+
+template <class Tree>
+bool is_valid(Tree& red_black_tree)
+{
+    using value_type = std::remove_cvref_t<decltype(red_black_tree.get_root()->value)>;
+    using compare_type = std::remove_cvref_t<decltype(red_black_tree.get_comparator())>;
+
+    ThreeWayCompare<value_type, compare_type> compare(red_black_tree.get_comparator());
+
+    return red_black_tree.get_root()->is_black()
+        && red_black_tree.get_null_node()->is_black()
+        && valid_black_height(red_black_tree.get_root(), red_black_tree.get_null_node(), red_black_tree.get_null_node(), compare)
+            == int(red_black_tree.black_height());
+}
+
 #endif
\ No newline at end of file
@@ -1,6 +1,19 @@
 #include "catch.hpp"
 #include "RBTreeTest.hpp"
 
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 SCENARIO("Testing insert function")
 {
     GIVEN("An empty tree")
@@ -533,4 +546,1625 @@ SCENARIO("Testing clear function")
             }
         }
     }
-}
\ No newline at end of file
+}
+SCENARIO("Testing compact nodes")
+{
+    GIVEN("A compact node")
+    {
+        CompactNode<int> null_node;
+        CompactNode<int> parent(1, &null_node, &null_node);
+        CompactNode<int> child(2, &parent, &null_node);
+
+        THEN("A compact node of int should take 32 bytes")
+        {
+            REQUIRE(sizeof(CompactNode<int>) == 32);
+        }
+
+        THEN("The parent and the color should be stored together")
+        {
+            REQUIRE(child.get_parent() == &parent);
+            CHECK(child.is_red());
+            CHECK(null_node.is_black());
+        }
+
+        WHEN("The color is changed")
+        {
+            child.make_black();
+
+            THEN("The parent shouldn't change")
+            {
+                REQUIRE(child.get_parent() == &parent);
+                CHECK(child.is_black());
+            }
+        }
+
+        WHEN("The parent is changed")
+        {
+            child.set_parent(&null_node);
+
+            THEN("The color shouldn't change")
+            {
+                REQUIRE(child.get_parent() == &null_node);
+                CHECK(child.is_red());
+            }
+        }
+    }
+
+    GIVEN("A tree of compact nodes and a tree of regular nodes with the same elements")
+    {
+        tree test;
+        RBTreeTest<int, MyAllocator<CompactNode<int>>> compact_test;
+
+        for(int i = 1; i <= 100; ++i)
+        {
+            test.insert(i * 7 % 101);
+            compact_test.insert(i * 7 % 101);
+        }
+
+        THEN("Both trees should have the same shape")
+        {
+            REQUIRE(test.height() == compact_test.height());
+            REQUIRE(test.black_height() == compact_test.black_height());
+            REQUIRE(test.get_root()->value == compact_test.get_root()->value);
+        }
+
+        WHEN("Elements are erased from both trees")
+        {
+            for(int i = 1; i <= 100; i += 3)
+            {
+                test.erase(i);
+                compact_test.erase(i);
+            }
+
+            THEN("Both trees should stay the same")
+            {
+                REQUIRE(test.height() == compact_test.height());
+                REQUIRE(test.black_height() == compact_test.black_height());
+                REQUIRE(test.get_root()->value == compact_test.get_root()->value);
+
+                for(int i = 1; i <= 100; ++i)
+                    REQUIRE(test.exists(i) == compact_test.exists(i));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing rvalue insert and emplace")
+{
+    GIVEN("A tree of strings")
+    {
+        RBTree<std::string> test;
+        test.insert("b");
+
+        WHEN("A string is inserted by rvalue")
+        {
+            std::string value(64, 'a');
+            test.insert(std::move(value));
+
+            THEN("The string should be moved into the tree")
+            {
+                CHECK(value.empty());
+                CHECK(test.exists(std::string(64, 'a')));
+            }
+        }
+
+        WHEN("A string is constructed in place")
+        {
+            test.emplace(3, 'c');
+
+            THEN("The new element should exist in the tree")
+            {
+                CHECK(test.exists("ccc"));
+                REQUIRE(test.get_allocator().size() == 3);
+            }
+        }
+
+        WHEN("An existing string is constructed in place")
+        {
+            THEN("An exception should be thrown")
+            {
+                REQUIRE_THROWS_AS(test.emplace(1, 'b'), std::invalid_argument);
+            }
+
+            THEN("The new node should be deallocated")
+            {
+                CHECK_THROWS(test.emplace(1, 'b'));
+                REQUIRE(test.get_allocator().size() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing node handles")
+{
+    GIVEN("Two non-empty trees")
+    {
+        tree staging, live;
+
+        init_tree(staging);
+        init_tree_negative(live);
+
+        tree copy_staging(staging);
+
+        WHEN("An element is extracted")
+        {
+            node_ptr extracted_node = staging.get_root()->right;
+            tree::node_handle handle = staging.extract(extracted_node->value);
+
+            THEN("The handle should own the node")
+            {
+                CHECK_FALSE(handle.empty());
+                REQUIRE(handle.value() == 6);
+            }
+
+            THEN("The element shouldn't exist in the tree")
+            {
+                CHECK_FALSE(staging.exists(6));
+                REQUIRE(staging.get_allocator().size() == 10);
+            }
+
+            THEN("The other elements should stay in the tree")
+            {
+                for(int i = 1; i <= 10; ++i)
+                    if(i != 6)
+                        CHECK(staging.exists(i));
+            }
+
+            THEN("The node can be inserted in another tree without reallocation")
+            {
+                live.insert(std::move(handle));
+
+                CHECK(handle.empty());
+                CHECK(live.exists(6));
+                REQUIRE(live.get_allocator().size() == 12);
+                CHECK(live.extract(6).value() == extracted_node->value);
+            }
+
+            THEN("The node can be inserted back with a changed element")
+            {
+                handle.value() = 11;
+                staging.insert(std::move(handle));
+
+                CHECK(staging.exists(11));
+                REQUIRE(staging.get_allocator().size() == 11);
+            }
+
+            THEN("Inserting an existing element should throw and keep the node in the handle")
+            {
+                handle.value() = 1;
+
+                REQUIRE_THROWS_AS(staging.insert(std::move(handle)), std::invalid_argument);
+                CHECK_FALSE(handle.empty());
+            }
+
+            THEN("Assigning another extracted node should deallocate the owned node and take the new one")
+            {
+                handle = staging.extract(1);
+
+                CHECK(handle.value() == 1);
+                CHECK_FALSE(staging.exists(1));
+                REQUIRE(staging.get_allocator().size() == 9);
+
+                live.insert(std::move(handle));
+
+                CHECK(live.exists(1));
+                REQUIRE(live.get_allocator().size() == 12);
+            }
+
+            THEN("Assigning an empty handle should deallocate the owned node")
+            {
+                handle = tree::node_handle();
+
+                CHECK(handle.empty());
+                REQUIRE(staging.get_allocator().size() == 10);
+            }
+        }
+
+        WHEN("An element that doesn't exist is extracted")
+        {
+            tree::node_handle handle = staging.extract(11);
+
+            THEN("The handle should be empty")
+            {
+                CHECK(handle.empty());
+                CHECK(are_equal(staging, copy_staging));
+            }
+        }
+    }
+
+    GIVEN("Trees with polymorphic allocators over different resources")
+    {
+        std::pmr::unsynchronized_pool_resource resource1, resource2;
+
+        RBTree<int, std::pmr::polymorphic_allocator<int>> tree1(&resource1), tree2(&resource2);
+        tree1.insert(1);
+
+        WHEN("A node is moved between them")
+        {
+            auto handle = tree1.extract(1);
+
+            THEN("An exception should be thrown")
+            {
+                REQUIRE_THROWS_AS(tree2.insert(std::move(handle)), std::invalid_argument);
+                CHECK_FALSE(handle.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Testing random inserts and erases")
+{
+    GIVEN("A tree with many elements inserted in random order")
+    {
+        tree test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        THEN("The tree should be valid")
+        {
+            CHECK(is_valid(test));
+        }
+
+        WHEN("Half of the elements are erased in random order")
+        {
+            for(int i = 0; i < 1000; i += 2)
+                test.erase(i * 7919 % 1000);
+
+            THEN("The tree should stay valid")
+            {
+                CHECK(is_valid(test));
+                REQUIRE(test.get_allocator().size() == 501);
+            }
+
+            THEN("Only the erased elements should be missing")
+            {
+                for(int i = 0; i < 1000; ++i)
+                    REQUIRE(test.exists(i * 7919 % 1000) == (i % 2 == 1));
+            }
+        }
+    }
+}
+
+SCENARIO("Testing custom comparators")
+{
+    GIVEN("A tree ordered by std::greater")
+    {
+        RBTreeTest<int, MyAllocator<Node<int>>, std::greater<int>> test;
+
+        for(int i = 0; i < 100; ++i)
+            test.insert(i * 37 % 100);
+
+        THEN("The tree should be valid and the elements should be ordered from the largest")
+        {
+            CHECK(is_valid(test));
+            REQUIRE(test.get_root()->left->value > test.get_root()->value);
+            REQUIRE(test.get_root()->right->value < test.get_root()->value);
+        }
+
+        THEN("All elements should exist")
+        {
+            for(int i = 0; i < 100; ++i)
+                REQUIRE(test.exists(i));
+
+            REQUIRE_FALSE(test.exists(100));
+        }
+
+        WHEN("An existing element is inserted again")
+        {
+            THEN("An exception should be thrown")
+            {
+                REQUIRE_THROWS_AS(test.insert(42), std::invalid_argument);
+            }
+        }
+    }
+
+    GIVEN("A tree of strings with a comparator that returns an ordering")
+    {
+        RBTreeTest<std::string, MyAllocator<Node<std::string>>, std::compare_three_way> test;
+
+        test.insert("b");
+        test.insert("a");
+        test.insert("c");
+
+        THEN("The elements should be ordered and found")
+        {
+            REQUIRE(test.get_root()->value == "b");
+            REQUIRE(test.get_root()->left->value == "a");
+            REQUIRE(test.get_root()->right->value == "c");
+            REQUIRE(test.exists("a"));
+            REQUIRE_FALSE(test.exists("d"));
+        }
+
+        WHEN("An element is erased")
+        {
+            test.erase("a");
+
+            THEN("It should no longer exist")
+            {
+                REQUIRE_FALSE(test.exists("a"));
+                CHECK(is_valid(test));
+            }
+        }
+    }
+
+    GIVEN("A tree with a comparator that has state")
+    {
+        auto by_last_digit = [](int lhs, int rhs){ return lhs % 10 < rhs % 10; };
+        RBTree<int, MyAllocator<Node<int>>, decltype(by_last_digit)> test(by_last_digit);
+
+        test.insert(13);
+
+        THEN("Elements that are equivalent by the comparator should be rejected")
+        {
+            REQUIRE(test.exists(3));
+            REQUIRE_THROWS_AS(test.insert(23), std::invalid_argument);
+        }
+    }
+}
+
+SCENARIO("Testing try_insert and try_erase")
+{
+    GIVEN("A tree with elements from 1 to 10")
+    {
+        tree test;
+        init_tree(test);
+
+        WHEN("A new element is inserted with try_insert")
+        {
+            auto [element, inserted] = test.try_insert(11);
+
+            THEN("It should be inserted and the returned element should be the new one")
+            {
+                REQUIRE(inserted);
+                REQUIRE(*element == 11);
+                REQUIRE(element == test.find(11));
+                REQUIRE(test.exists(11));
+                CHECK(is_valid(test));
+            }
+        }
+
+        WHEN("An existing element is inserted with try_insert")
+        {
+            int existing = 5;
+            auto [element, inserted] = test.try_insert(std::move(existing));
+
+            THEN("Nothing should be allocated and the existing element should be returned")
+            {
+                REQUIRE_FALSE(inserted);
+                REQUIRE(*element == 5);
+                REQUIRE(test.get_allocator().size() == 11);
+                CHECK(is_valid(test));
+            }
+        }
+
+        WHEN("An existing element is erased with try_erase")
+        {
+            THEN("One element should be erased")
+            {
+                REQUIRE(test.try_erase(5) == 1);
+                REQUIRE_FALSE(test.exists(5));
+                CHECK(is_valid(test));
+            }
+        }
+
+        WHEN("A missing element is erased with try_erase")
+        {
+            THEN("Nothing should be erased")
+            {
+                REQUIRE(test.try_erase(42) == 0);
+                REQUIRE(test.get_allocator().size() == 11);
+            }
+        }
+
+        WHEN("An existing element is emplaced")
+        {
+            THEN("An exception should be thrown and the new node should be deallocated")
+            {
+                REQUIRE_THROWS_AS(test.emplace(5), std::invalid_argument);
+                REQUIRE(test.get_allocator().size() == 11);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing iterators")
+{
+    GIVEN("An empty tree")
+    {
+        tree test;
+
+        THEN("begin should be equal to end")
+        {
+            REQUIRE(test.begin() == test.end());
+            REQUIRE(test.rbegin() == test.rend());
+            REQUIRE(test.find(1) == test.end());
+        }
+    }
+
+    GIVEN("A tree with many elements inserted in random order")
+    {
+        tree test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        THEN("The elements should be visited in order")
+        {
+            int expected = 0;
+
+            for(int value : test)
+                REQUIRE(value == expected++);
+
+            REQUIRE(expected == 1000);
+        }
+
+        THEN("The elements should be visited in reverse order")
+        {
+            int expected = 999;
+
+            for(auto iter = test.rbegin(); iter != test.rend(); ++iter)
+                REQUIRE(*iter == expected--);
+
+            REQUIRE(expected == -1);
+        }
+
+        THEN("Stepping back from end should give the largest element")
+        {
+            auto iter = test.end();
+
+            REQUIRE(*--iter == 999);
+            REQUIRE(*iter-- == 999);
+            REQUIRE(*iter == 998);
+            REQUIRE(*++iter == 999);
+            REQUIRE(++iter == test.end());
+        }
+
+        THEN("find should return an iterator to the element")
+        {
+            auto iter = test.find(500);
+
+            REQUIRE(*iter == 500);
+            REQUIRE(*++iter == 501);
+        }
+
+        WHEN("Other elements are erased")
+        {
+            auto iter = test.find(500);
+
+            for(int i = 0; i < 1000; ++i)
+                if(i != 500)
+                    test.erase(i);
+
+            THEN("The iterator should still point to its element")
+            {
+                REQUIRE(*iter == 500);
+                REQUIRE(++iter == test.end());
+                REQUIRE(test.begin() == test.find(500));
+            }
+        }
+    }
+
+    GIVEN("A compact tree ordered by std::greater")
+    {
+        RBTree<int, MyAllocator<CompactNode<int>>, std::greater<int>> test;
+
+        for(int i = 0; i < 100; ++i)
+            test.insert(i * 37 % 100);
+
+        THEN("The elements should be visited from the largest")
+        {
+            int expected = 99;
+
+            for(int value : test)
+                REQUIRE(value == expected--);
+
+            REQUIRE(expected == -1);
+        }
+    }
+}
+
+SCENARIO("Testing range queries")
+{
+    GIVEN("A tree with the even numbers from 0 to 98")
+    {
+        tree test;
+
+        for(int i = 0; i < 50; ++i)
+            test.insert(i * 17 % 50 * 2);
+
+        THEN("lower_bound should return the first element that is not less than the value")
+        {
+            REQUIRE(*test.lower_bound(10) == 10);
+            REQUIRE(*test.lower_bound(11) == 12);
+            REQUIRE(*test.lower_bound(-5) == 0);
+            REQUIRE(test.lower_bound(99) == test.end());
+        }
+
+        THEN("upper_bound should return the first element that is greater than the value")
+        {
+            REQUIRE(*test.upper_bound(10) == 12);
+            REQUIRE(*test.upper_bound(11) == 12);
+            REQUIRE(*test.upper_bound(-5) == 0);
+            REQUIRE(test.upper_bound(98) == test.end());
+        }
+
+        THEN("equal_range should match lower_bound and upper_bound")
+        {
+            for(int i = -1; i <= 100; ++i)
+            {
+                auto [first, last] = test.equal_range(i);
+
+                REQUIRE(first == test.lower_bound(i));
+                REQUIRE(last == test.upper_bound(i));
+            }
+        }
+
+        THEN("for_each_in_range should visit the elements in [low, high) in order")
+        {
+            std::vector<int> visited;
+            test.for_each_in_range(10, 20, [&](int value){ visited.push_back(value); });
+
+            REQUIRE(visited == std::vector<int>{10, 12, 14, 16, 18});
+        }
+
+        THEN("for_each_in_range should visit nothing for an empty range")
+        {
+            size_t count = 0;
+            test.for_each_in_range(11, 12, [&](int){ ++count; });
+            test.for_each_in_range(200, 300, [&](int){ ++count; });
+
+            REQUIRE(count == 0);
+        }
+    }
+}
+
+SCENARIO("Testing order statistics")
+{
+    GIVEN("A tree with subtree sizes and the even numbers from 0 to 1998 inserted in random order")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000 * 2);
+
+        THEN("The sizes of all subtrees should be valid")
+        {
+            CHECK(is_valid(test));
+            CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+            REQUIRE(test.size() == 1000);
+        }
+
+        THEN("select should return the k-th smallest element")
+        {
+            for(size_t k = 0; k < 1000; ++k)
+                REQUIRE(*test.select(k) == int(2 * k));
+
+            REQUIRE(test.select(1000) == test.end());
+        }
+
+        THEN("rank should return the number of smaller elements")
+        {
+            REQUIRE(test.rank(-1) == 0);
+            REQUIRE(test.rank(0) == 0);
+            REQUIRE(test.rank(1) == 1);
+            REQUIRE(test.rank(1000) == 500);
+            REQUIRE(test.rank(5000) == 1000);
+        }
+
+        THEN("count_range should return the number of elements in [low, high)")
+        {
+            REQUIRE(test.count_range(0, 10) == 5);
+            REQUIRE(test.count_range(1, 11) == 5);
+            REQUIRE(test.count_range(10, 0) == 0);
+            REQUIRE(test.count_range(-100, 5000) == 1000);
+        }
+
+        WHEN("Elements are erased and inserted again")
+        {
+            for(int i = 0; i < 1000; i += 3)
+                test.erase(i * 7919 % 1000 * 2);
+
+            for(int i = 0; i < 1000; i += 6)
+                test.insert(i * 7919 % 1000 * 2);
+
+            THEN("The sizes should stay valid")
+            {
+                CHECK(is_valid(test));
+                CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+                REQUIRE(test.size() == 1000 - 334 + 167);
+            }
+
+            THEN("select and rank should agree with an in-order walk")
+            {
+                size_t k = 0;
+
+                for(int value : test)
+                {
+                    REQUIRE(*test.select(k) == value);
+                    REQUIRE(test.rank(value) == k);
+                    ++k;
+                }
+            }
+        }
+
+        WHEN("The tree is copied")
+        {
+            RBTreeTest<int, MyAllocator<SizedNode<int>>> copy(test);
+
+            THEN("The copy should keep the sizes")
+            {
+                CHECK(valid_sizes(copy.get_root(), copy.get_null_node()));
+                REQUIRE(copy.size() == 1000);
+            }
+        }
+    }
+
+    GIVEN("A tree with subtree sizes and recycled nodes")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> test;
+        test.set_recycle_limit(10);
+
+        for(int i = 0; i < 100; ++i)
+            test.insert(i);
+
+        WHEN("Elements are erased and their nodes are reused")
+        {
+            for(int i = 0; i < 10; ++i)
+                test.erase(i);
+
+            for(int i = 100; i < 110; ++i)
+                test.emplace(i);
+
+            THEN("The sizes should be valid")
+            {
+                CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+                REQUIRE(test.size() == 100);
+                REQUIRE(*test.select(0) == 10);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing augmentation")
+{
+    GIVEN("A tree with subtree sums and the numbers from 0 to 999 inserted in random order")
+    {
+        RBTreeTest<int, MyAllocator<AugmentedNode<int, SumAugmentation<int>>>> test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        THEN("The summaries should be valid")
+        {
+            CHECK(is_valid(test));
+            CHECK(valid_summaries(test.get_root(), test.get_null_node()));
+            REQUIRE(test.aggregate() == 999 * 1000 / 2);
+        }
+
+        THEN("range_aggregate should return the sum of the elements in [low, high)")
+        {
+            REQUIRE(test.range_aggregate(0, 1000) == 999 * 1000 / 2);
+            REQUIRE(test.range_aggregate(10, 20) == 145);
+            REQUIRE(test.range_aggregate(-10, 1) == 0);
+            REQUIRE(test.range_aggregate(999, 5000) == 999);
+            REQUIRE(test.range_aggregate(20, 10) == 0);
+            REQUIRE(test.range_aggregate(5000, 6000) == 0);
+        }
+
+        THEN("range_aggregate should match a scan for many ranges")
+        {
+            for(int low = -5; low < 1005; low += 37)
+                for(int high = low; high < 1010; high += 53)
+                {
+                    int expected = 0;
+                    test.for_each_in_range(low, high, [&](int value){ expected += value; });
+
+                    REQUIRE(test.range_aggregate(low, high) == expected);
+                }
+        }
+
+        WHEN("Elements are erased")
+        {
+            for(int i = 0; i < 1000; i += 2)
+                test.erase(i * 7919 % 1000);
+
+            THEN("The summaries should stay valid")
+            {
+                CHECK(is_valid(test));
+                CHECK(valid_summaries(test.get_root(), test.get_null_node()));
+                REQUIRE(test.range_aggregate(0, 4) == 4);
+            }
+        }
+    }
+
+    GIVEN("A tree of pairs with the maximum of the payloads")
+    {
+        struct Payload{
+            int operator()(const std::pair<int, int>& element) const { return element.second; }
+        };
+
+        RBTree<std::pair<int, int>, MyAllocator<AugmentedNode<std::pair<int, int>, MaxAugmentation<std::pair<int, int>, Payload>>>> test;
+
+        for(int i = 0; i < 100; ++i)
+            test.insert({i, (i * 37) % 101});
+
+        THEN("range_aggregate should return the maximum payload in the range")
+        {
+            REQUIRE(test.aggregate() == 100);
+            REQUIRE(test.range_aggregate({0, 0}, {3, 0}) == 74);
+            REQUIRE(test.range_aggregate({5, 0}, {5, 0}) == std::numeric_limits<int>::lowest());
+        }
+    }
+}
+
+SCENARIO("Testing batch lookups")
+{
+    GIVEN("A tree with the even numbers from 0 to 1998")
+    {
+        tree test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000 * 2);
+
+        std::vector<int> values;
+
+        for(int i = -10; i < 2010; i += 3)
+            values.push_back(i);
+
+        WHEN("The values are checked with exists_batch")
+        {
+            std::unique_ptr<bool[]> results(new bool[values.size()]);
+            test.exists_batch(values, std::span<bool>(results.get(), values.size()));
+
+            THEN("The results should match exists")
+            {
+                for(size_t i = 0; i < values.size(); ++i)
+                    REQUIRE(results[i] == test.exists(values[i]));
+            }
+        }
+
+        WHEN("The values are found with find_batch")
+        {
+            std::vector<tree::const_iterator> results(values.size());
+            test.find_batch(values, results);
+
+            THEN("The results should match find")
+            {
+                for(size_t i = 0; i < values.size(); ++i)
+                    REQUIRE(results[i] == test.find(values[i]));
+            }
+        }
+
+        WHEN("There is not enough space for the results")
+        {
+            std::vector<tree::const_iterator> results(values.size() - 1);
+
+            THEN("An exception should be thrown")
+            {
+                REQUIRE_THROWS_AS(test.find_batch(values, results), std::invalid_argument);
+            }
+        }
+    }
+
+    GIVEN("An empty tree")
+    {
+        tree test;
+        std::vector<int> values = {1, 2, 3};
+        bool results[3] = {true, true, true};
+
+        THEN("No value should exist")
+        {
+            test.exists_batch(values, results);
+
+            REQUIRE_FALSE(results[0]);
+            REQUIRE_FALSE(results[1]);
+            REQUIRE_FALSE(results[2]);
+        }
+    }
+}
+
+SCENARIO("Testing finger search")
+{
+    GIVEN("A tree filled with sorted inserts through hints")
+    {
+        tree test;
+        tree::const_iterator hint = test.end();
+
+        for(int i = 0; i < 1000; ++i)
+            hint = test.insert(hint, i * 2);
+
+        THEN("The tree should be valid and contain all elements in order")
+        {
+            CHECK(is_valid(test));
+
+            int expected = 0;
+
+            for(int value : test)
+            {
+                REQUIRE(value == expected);
+                expected += 2;
+            }
+
+            REQUIRE(expected == 2000);
+        }
+
+        THEN("Sorted lookups through hints should find every element")
+        {
+            tree::const_iterator finger = test.end();
+
+            for(int i = 0; i < 2000; ++i)
+            {
+                tree::const_iterator found = test.find(finger, i);
+
+                REQUIRE(found == test.find(i));
+
+                if(found != test.end())
+                    finger = found;
+            }
+        }
+
+        THEN("Lookups far from the hint should find the elements as well")
+        {
+            tree::const_iterator finger = test.find(1000);
+
+            REQUIRE(*test.find(finger, 0) == 0);
+            REQUIRE(*test.find(finger, 1998) == 1998);
+            REQUIRE(test.find(finger, 1001) == test.end());
+            REQUIRE(test.find(finger, -1) == test.end());
+        }
+
+        WHEN("An existing element is inserted with a hint")
+        {
+            tree::const_iterator existing = test.insert(test.find(100), 500);
+
+            THEN("The existing element should be returned and nothing should be allocated")
+            {
+                REQUIRE(existing == test.find(500));
+                REQUIRE(test.get_allocator().size() == 1001);
+            }
+        }
+
+        WHEN("Odd elements are inserted with hints in descending order")
+        {
+            tree::const_iterator finger = test.end();
+
+            for(int i = 999; i >= 0; --i)
+                finger = test.insert(finger, i * 2 + 1);
+
+            THEN("The tree should be valid and contain all elements")
+            {
+                CHECK(is_valid(test));
+
+                int expected = 0;
+
+                for(int value : test)
+                    REQUIRE(value == expected++);
+
+                REQUIRE(expected == 2000);
+            }
+        }
+    }
+
+    GIVEN("A tree with subtree sizes filled through hints")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> test;
+        auto hint = test.end();
+
+        for(int i = 0; i < 500; ++i)
+            hint = test.insert(hint, i);
+
+        THEN("The sizes should be valid")
+        {
+            CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+            REQUIRE(test.size() == 500);
+        }
+    }
+}
+
+SCENARIO("Testing assign_sorted")
+{
+    GIVEN("Sorted ranges of every size up to 100")
+    {
+        THEN("The built trees should be valid and contain the elements in order")
+        {
+            for(int count = 0; count <= 100; ++count)
+            {
+                std::vector<int> values;
+
+                for(int i = 0; i < count; ++i)
+                    values.push_back(i * 3);
+
+                tree test;
+                test.assign_sorted(values.begin(), values.end());
+
+                REQUIRE(is_valid(test));
+                REQUIRE(test.get_allocator().size() == size_t(count + 1));
+                REQUIRE(std::equal(test.begin(), test.end(), values.begin(), values.end()));
+            }
+        }
+    }
+
+    GIVEN("A tree with elements")
+    {
+        tree test;
+        init_tree(test);
+
+        WHEN("A sorted range is assigned")
+        {
+            std::vector<int> values = {100, 200, 300};
+            test.assign_sorted(values.begin(), values.end());
+
+            THEN("Only the new elements should be in the tree")
+            {
+                REQUIRE_FALSE(test.exists(1));
+                REQUIRE(test.exists(200));
+                REQUIRE(test.get_allocator().size() == 4);
+            }
+
+            THEN("New elements can be inserted and erased")
+            {
+                test.insert(150);
+                test.erase(100);
+
+                CHECK(is_valid(test));
+            }
+        }
+
+        WHEN("A range that is not strictly increasing is assigned")
+        {
+            std::vector<int> values = {1, 3, 3, 4};
+
+            THEN("An exception should be thrown and the tree shouldn't change")
+            {
+                REQUIRE_THROWS_AS(test.assign_sorted(values.begin(), values.end()), std::invalid_argument);
+                REQUIRE(test.exists(10));
+                REQUIRE(test.get_allocator().size() == 11);
+            }
+        }
+    }
+
+    GIVEN("A tree with subtree sizes built from a sorted range")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> test;
+        std::vector<int> values(1000);
+
+        for(int i = 0; i < 1000; ++i)
+            values[i] = i;
+
+        test.assign_sorted(values.begin(), values.end());
+
+        THEN("The sizes should be valid")
+        {
+            CHECK(is_valid(test));
+            CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+            REQUIRE(*test.select(500) == 500);
+        }
+    }
+
+    GIVEN("A slab tree built from a sorted range")
+    {
+        RBTreeTest<std::string, SlabAllocator<Node<std::string>>> test;
+        std::vector<std::string> values;
+
+        for(int i = 0; i < 1000; ++i)
+            values.push_back(std::string(20, 'k') + std::to_string(1000 + i));
+
+        test.assign_sorted(values.begin(), values.end());
+
+        THEN("The tree should be valid and own all nodes")
+        {
+            CHECK(is_valid(test));
+            REQUIRE(test.get_allocator().size() == 1001);
+            REQUIRE(test.exists(values[123]));
+        }
+
+        THEN("The nodes should be adjacent in one block")
+        {
+            std::vector<std::uintptr_t> addresses;
+            std::vector<Node<std::string>*> stack = {test.get_root()};
+
+            while(!stack.empty())
+            {
+                Node<std::string>* node = stack.back();
+                stack.pop_back();
+
+                if(node == test.get_null_node())
+                    continue;
+
+                addresses.push_back(reinterpret_cast<std::uintptr_t>(node));
+                stack.push_back(node->right);
+                stack.push_back(node->left);
+            }
+
+            std::sort(addresses.begin(), addresses.end());
+
+            REQUIRE(addresses.size() == 1000);
+
+            for(size_t i = 1; i < addresses.size(); ++i)
+                REQUIRE(addresses[i] - addresses[i - 1] == sizeof(Node<std::string>));
+        }
+
+        WHEN("The tree is rebuilt")
+        {
+            test.assign_sorted(values.begin(), values.begin() + 10);
+
+            THEN("The tree should contain only the new elements")
+            {
+                CHECK(is_valid(test));
+                REQUIRE(test.get_allocator().size() == 11);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing split and join")
+{
+    GIVEN("A tree with the numbers from 0 to 999")
+    {
+        tree test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        THEN("Splitting at any key should give two valid trees with the right elements")
+        {
+            for(int key = -1; key <= 1001; key += 50)
+            {
+                tree copy(test);
+                auto [left_part, right_part] = std::move(copy).split(key);
+                tree left(std::move(left_part)), right(std::move(right_part));
+
+                int clamped = std::clamp(key, 0, 1000);
+
+                REQUIRE(is_valid(left));
+                REQUIRE(is_valid(right));
+                REQUIRE(left.get_allocator().size() == size_t(clamped + 1));
+                REQUIRE(right.get_allocator().size() == size_t(1000 - clamped + 1));
+                REQUIRE(std::equal(left.begin(), left.end(), test.begin(), test.lower_bound(clamped)));
+                REQUIRE(std::equal(right.begin(), right.end(), test.lower_bound(clamped), test.end()));
+            }
+        }
+
+        WHEN("The tree is split and joined back")
+        {
+            tree copy(test);
+            auto [left, right] = std::move(copy).split(500);
+            right.erase(500);
+
+            tree joined(RBTree<int>::join(std::move(left), 500, std::move(right)));
+
+            THEN("The joined tree should be valid and contain all elements")
+            {
+                CHECK(is_valid(joined));
+                REQUIRE(std::equal(joined.begin(), joined.end(), test.begin(), test.end()));
+                REQUIRE(joined.get_allocator().size() == 1001);
+                REQUIRE(right.empty());
+                REQUIRE(right.get_allocator().size() == 1);
+            }
+
+            THEN("The joined tree should be usable")
+            {
+                joined.erase(500);
+                joined.insert(1000);
+
+                CHECK(is_valid(joined));
+                REQUIRE(joined.exists(1000));
+            }
+        }
+    }
+
+    GIVEN("Trees of very different sizes")
+    {
+        THEN("Joining them in both orders should give valid trees")
+        {
+            for(int count = 0; count < 40; count += 3)
+            {
+                tree big, small, other_big, other_small;
+
+                for(int i = 0; i < 500; ++i)
+                {
+                    big.insert(i);
+                    other_big.insert(i);
+                }
+
+                for(int i = 0; i < count; ++i)
+                {
+                    small.insert(1000 + i);
+                    other_small.insert(-1000 - i);
+                }
+
+                tree joined(RBTree<int>::join(std::move(big), 700, std::move(small)));
+                tree reversed(RBTree<int>::join(std::move(other_small), -1, std::move(other_big)));
+
+                REQUIRE(is_valid(joined));
+                REQUIRE(is_valid(reversed));
+                REQUIRE(joined.get_allocator().size() == size_t(500 + count + 2));
+                REQUIRE(reversed.get_allocator().size() == size_t(500 + count + 2));
+                REQUIRE(std::is_sorted(joined.begin(), joined.end()));
+                REQUIRE(std::is_sorted(reversed.begin(), reversed.end()));
+            }
+        }
+    }
+
+    GIVEN("A tiny tree and a large tree after it")
+    {
+        tree tiny, large;
+
+        for(int i = 0; i < 3; ++i)
+            tiny.insert(i);
+
+        for(int i = 10; i < 5000; ++i)
+            large.insert(i);
+
+        node_ptr large_null_node = large.get_null_node();
+        node_ptr large_root = large.get_root();
+
+        WHEN("The tiny tree is joined onto the large one")
+        {
+            tree joined(RBTree<int>::join(std::move(tiny), 5, std::move(large)));
+
+            THEN("The large tree should keep its nodes and only the tiny one should be moved")
+            {
+                CHECK(is_valid(joined));
+                REQUIRE(joined.get_null_node() == large_null_node);
+                REQUIRE(joined.get_allocator().size() == 3 + 1 + 4990 + 1);
+                REQUIRE(joined.exists(large_root->value));
+                REQUIRE(*joined.begin() == 0);
+                REQUIRE(std::is_sorted(joined.begin(), joined.end()));
+            }
+        }
+
+        WHEN("The large tree is split near its front")
+        {
+            auto [left_part, right_part] = std::move(large).split(13);
+            tree left(std::move(left_part)), right(std::move(right_part));
+
+            THEN("The right part should keep the tree and only the front should be moved")
+            {
+                CHECK(is_valid(left));
+                CHECK(is_valid(right));
+                REQUIRE(right.get_null_node() == large_null_node);
+                REQUIRE(left.get_allocator().size() == 3 + 1);
+                REQUIRE(right.get_allocator().size() == 4987 + 1);
+                REQUIRE(*right.begin() == 13);
+            }
+        }
+    }
+
+    GIVEN("Two trees whose elements overlap the pivot")
+    {
+        tree left, right;
+        left.insert(10);
+        right.insert(20);
+
+        THEN("join should throw an exception")
+        {
+            REQUIRE_THROWS_AS(RBTree<int>::join(std::move(left), 25, std::move(right)), std::invalid_argument);
+            REQUIRE_THROWS_AS(RBTree<int>::join(std::move(left), 5, std::move(right)), std::invalid_argument);
+        }
+    }
+
+    GIVEN("A tree with subtree sizes")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i);
+
+        WHEN("It is split")
+        {
+            auto [left_part, right_part] = std::move(test).split(300);
+            RBTreeTest<int, MyAllocator<SizedNode<int>>> left(std::move(left_part)), right(std::move(right_part));
+
+            THEN("The sizes of both parts should be valid")
+            {
+                CHECK(valid_sizes(left.get_root(), left.get_null_node()));
+                CHECK(valid_sizes(right.get_root(), right.get_null_node()));
+                REQUIRE(left.size() == 300);
+                REQUIRE(right.size() == 700);
+                REQUIRE(*right.select(0) == 300);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing set union, intersection and difference")
+{
+    GIVEN("The multiples of 2 and of 3 below 240000 in two trees")
+    {
+        std::vector<int> twos, threes;
+
+        for(int i = 0; i < 240000; ++i)
+        {
+            int value = int(i * 7919LL % 240000);
+
+            if(value % 2 == 0)
+                twos.push_back(value);
+
+            if(value % 3 == 0)
+                threes.push_back(value);
+        }
+
+        auto build = [](const std::vector<int>& values){
+            tree result;
+
+            for(int value : values)
+                result.insert(value);
+
+            return result;
+        };
+
+        std::vector<int> expected_union, expected_intersection, expected_difference, expected_reverse_difference;
+
+        for(int value = 0; value < 240000; ++value)
+        {
+            if(value % 2 == 0 || value % 3 == 0)
+                expected_union.push_back(value);
+
+            if(value % 2 == 0 && value % 3 == 0)
+                expected_intersection.push_back(value);
+
+            if(value % 2 == 0 && value % 3 != 0)
+                expected_difference.push_back(value);
+
+            if(value % 3 == 0 && value % 2 != 0)
+                expected_reverse_difference.push_back(value);
+        }
+
+        for(size_t threads : {size_t(1), size_t(4)})
+        {
+            THEN("The operations with " + std::to_string(threads) + " threads should give valid trees with the right elements")
+            {
+                tree united(RBTree<int>::set_union(build(twos), build(threes), threads));
+                tree common(RBTree<int>::set_intersection(build(twos), build(threes), threads));
+                tree difference(RBTree<int>::set_difference(build(twos), build(threes), threads));
+                tree reverse_difference(RBTree<int>::set_difference(build(threes), build(twos), threads));
+
+                REQUIRE(is_valid(united));
+                REQUIRE(is_valid(common));
+                REQUIRE(is_valid(difference));
+                REQUIRE(is_valid(reverse_difference));
+
+                REQUIRE(united.get_allocator().size() == 160000 + 1);
+                REQUIRE(common.get_allocator().size() == 40000 + 1);
+                REQUIRE(difference.get_allocator().size() == 80000 + 1);
+                REQUIRE(reverse_difference.get_allocator().size() == 40000 + 1);
+
+                REQUIRE(std::equal(united.begin(), united.end(), expected_union.begin(), expected_union.end()));
+                REQUIRE(std::equal(common.begin(), common.end(), expected_intersection.begin(), expected_intersection.end()));
+                REQUIRE(std::equal(difference.begin(), difference.end(), expected_difference.begin(), expected_difference.end()));
+                REQUIRE(std::equal(reverse_difference.begin(), reverse_difference.end(),
+                                   expected_reverse_difference.begin(), expected_reverse_difference.end()));
+            }
+        }
+    }
+
+    GIVEN("A large and a small tree")
+    {
+        tree big, small;
+
+        for(int i = 0; i < 5000; ++i)
+            big.insert(i * 7919 % 5000);
+
+        for(int i = -10; i < 5010; i += 500)
+            small.insert(i);
+
+        THEN("The result should keep the elements of the first tree and be usable")
+        {
+            tree united(RBTree<int>::set_union(std::move(small), std::move(big), 4));
+
+            CHECK(is_valid(united));
+            REQUIRE(united.get_allocator().size() == 5000 + 1 + 1);
+            REQUIRE(std::is_sorted(united.begin(), united.end()));
+
+            united.erase(-10);
+            united.insert(-20);
+
+            REQUIRE(is_valid(united));
+        }
+
+        THEN("Operations with an empty tree should work")
+        {
+            tree empty;
+
+            tree united(RBTree<int>::set_union(tree(), std::move(small)));
+            tree common(RBTree<int>::set_intersection(std::move(big), std::move(empty)));
+
+            REQUIRE(is_valid(united));
+            REQUIRE(united.get_allocator().size() == 11 + 1);
+            REQUIRE(common.empty());
+            REQUIRE(common.get_allocator().size() == 1);
+        }
+    }
+
+    GIVEN("Two trees with subtree sizes")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> first, second;
+
+        for(int i = 0; i < 3000; ++i)
+        {
+            first.insert(i * 7919 % 3000);
+            second.insert(i * 7919 % 3000 + 1500);
+        }
+
+        THEN("The sizes of the union should be valid")
+        {
+            RBTreeTest<int, MyAllocator<SizedNode<int>>> united(
+                RBTree<int, MyAllocator<SizedNode<int>>>::set_union(std::move(first), std::move(second), 2));
+
+            CHECK(valid_sizes(united.get_root(), united.get_null_node()));
+            REQUIRE(united.size() == 4500);
+            REQUIRE(*united.select(2000) == 2000);
+        }
+    }
+}
+
+SCENARIO("Testing erase_range")
+{
+    GIVEN("A tree with the numbers from 0 to 999 inserted in random order")
+    {
+        tree test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        THEN("Erasing any range should leave a valid tree without its elements")
+        {
+            for(int low = -10; low < 1010; low += 97)
+            {
+                for(int high = low; high < 1020; high += 131)
+                {
+                    tree copy(test);
+
+                    int first = std::clamp(low, 0, 1000), last = std::clamp(high, 0, 1000);
+
+                    REQUIRE(copy.erase_range(low, high) == size_t(last - first));
+                    REQUIRE(is_valid(copy));
+                    REQUIRE(copy.get_allocator().size() == size_t(1000 - (last - first) + 1));
+                    REQUIRE(copy.lower_bound(low) == copy.lower_bound(high));
+                }
+            }
+        }
+
+        WHEN("All elements are erased")
+        {
+            REQUIRE(test.erase_range(0, 1000) == 1000);
+
+            THEN("The tree should be empty and usable")
+            {
+                REQUIRE(test.empty());
+                REQUIRE(test.get_allocator().size() == 1);
+
+                test.insert(5);
+
+                REQUIRE(is_valid(test));
+                REQUIRE(test.exists(5));
+            }
+        }
+
+        WHEN("The range is empty or reversed")
+        {
+            THEN("Nothing should be erased")
+            {
+                REQUIRE(test.erase_range(500, 500) == 0);
+                REQUIRE(test.erase_range(600, 400) == 0);
+                REQUIRE(test.get_allocator().size() == 1001);
+            }
+        }
+    }
+
+    GIVEN("A tree with subtree sizes")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>> test;
+
+        for(int i = 0; i < 1000; ++i)
+            test.insert(i * 7919 % 1000);
+
+        WHEN("A range is erased")
+        {
+            test.erase_range(100, 900);
+
+            THEN("The sizes should be valid")
+            {
+                CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+                REQUIRE(test.size() == 200);
+                REQUIRE(*test.select(100) == 900);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing insert_batch")
+{
+    GIVEN("A tree with the even numbers from 0 to 998")
+    {
+        tree test;
+
+        for(int i = 0; i < 500; ++i)
+            test.insert(i * 7919 % 500 * 2);
+
+        WHEN("A batch of all numbers from 0 to 1499 with duplicates is inserted")
+        {
+            std::vector<int> batch;
+
+            for(int i = 0; i < 1500; ++i)
+            {
+                batch.push_back(i * 7919 % 1500);
+                batch.push_back(i * 7 % 1500);
+            }
+
+            size_t inserted = test.insert_batch(batch);
+
+            THEN("Only the new numbers should be inserted and counted")
+            {
+                REQUIRE(inserted == 1000);
+                REQUIRE(is_valid(test));
+                REQUIRE(test.get_allocator().size() == 1500 + 1);
+
+                for(int i = 0; i < 1500; ++i)
+                    REQUIRE(test.exists(i));
+            }
+
+            THEN("The batch should be sorted")
+            {
+                REQUIRE(std::is_sorted(batch.begin(), batch.end()));
+            }
+        }
+
+        WHEN("An empty batch is inserted")
+        {
+            THEN("Nothing should change")
+            {
+                REQUIRE(test.insert_batch({}) == 0);
+                REQUIRE(test.get_allocator().size() == 500 + 1);
+            }
+        }
+    }
+
+    GIVEN("An empty tree with subtree sizes and the greater comparator")
+    {
+        RBTreeTest<int, MyAllocator<SizedNode<int>>, std::greater<int>> test;
+        std::vector<int> batch;
+
+        for(int i = 0; i < 1000; ++i)
+            batch.push_back(i * 7919 % 1000);
+
+        WHEN("A batch is inserted")
+        {
+            REQUIRE(test.insert_batch(batch) == 1000);
+
+            THEN("The tree should be valid and ordered by the comparator")
+            {
+                CHECK(is_valid(test));
+                CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+                REQUIRE(*test.begin() == 999);
+                REQUIRE(test.size() == 1000);
+            }
+        }
+    }
+}
+
+/**
+ * @brief orders numbers like std::less, every comparison throws while fail is set
+ */
+struct FailingLess{
+    static inline bool fail = false;
+
+    bool operator()(int lhs, int rhs) const
+    {
+        if(fail)
+            throw std::runtime_error("comparison failed");
+
+        return lhs < rhs;
+    }
+};
+
+SCENARIO("Testing build_parallel")
+{
+    GIVEN("An unsorted range of numbers with duplicates")
+    {
+        std::vector<int> values;
+
+        for(int i = 0; i < 150000; ++i)
+            values.push_back(int(i * 7919LL % 100000) - 50000);
+
+        for(size_t threads : {size_t(1), size_t(4), size_t(6)})
+        {
+            THEN("A tree built with " + std::to_string(threads) + " threads should be valid and contain every number once")
+            {
+                tree test;
+                test.insert(1000000);
+
+                test.build_parallel(values.begin(), values.end(), threads);
+
+                REQUIRE(is_valid(test));
+                REQUIRE(test.get_allocator().size() == 100000 + 1);
+                REQUIRE(*test.begin() == -50000);
+                REQUIRE(*std::prev(test.end()) == 49999);
+                REQUIRE(std::adjacent_find(test.begin(), test.end(), [](int lhs, int rhs){ return rhs != lhs + 1; }) == test.end());
+
+                test.insert(1000000);
+                test.erase(0);
+
+                REQUIRE(is_valid(test));
+            }
+        }
+    }
+
+    GIVEN("Strings in a tree with subtree sizes and a slab allocator")
+    {
+        std::vector<std::string> values;
+
+        for(int i = 0; i < 80000; ++i)
+            values.push_back(std::to_string(i * 7919 % 80000));
+
+        WHEN("The tree is built with 4 threads")
+        {
+            RBTreeTest<std::string, SlabAllocator<SizedNode<std::string>>> test;
+
+            test.build_parallel(values.begin(), values.end(), 4);
+
+            THEN("The tree should be valid and sorted")
+            {
+                CHECK(is_valid(test));
+                CHECK(valid_sizes(test.get_root(), test.get_null_node()));
+                REQUIRE(test.size() == 80000);
+                REQUIRE(test.get_allocator().size() == 80000 + 1);
+                REQUIRE(std::is_sorted(test.begin(), test.end()));
+                REQUIRE(test.exists("12345"));
+            }
+        }
+    }
+
+    GIVEN("A tree whose comparator throws while the range is sorted")
+    {
+        RBTreeTest<int, MyAllocator<Node<int>>, FailingLess> test;
+
+        for(int i = 0; i < 100; ++i)
+            test.insert(i);
+
+        std::vector<int> values(70000);
+        std::iota(values.rbegin(), values.rend(), 0);
+
+        WHEN("The tree is built from the range")
+        {
+            FailingLess::fail = true;
+
+            THEN("The tree should be left unchanged")
+            {
+                REQUIRE_THROWS_AS(test.build_parallel(values.begin(), values.end(), 4), std::runtime_error);
+
+                FailingLess::fail = false;
+
+                CHECK(is_valid(test));
+                REQUIRE(test.get_allocator().size() == 100 + 1);
+                REQUIRE(*test.begin() == 0);
+            }
+
+            FailingLess::fail = false;
+        }
+    }
+
+    GIVEN("Numbers in a tree ordered by the greater comparator")
+    {
+        std::vector<long long> values;
+
+        for(int i = 0; i < 70000; ++i)
+            values.push_back(i * 7919LL % 70000);
+
+        WHEN("The tree is built with 4 threads")
+        {
+            RBTreeTest<long long, MyAllocator<Node<long long>>, std::greater<long long>> test;
+
+            test.build_parallel(values.begin(), values.end(), 4);
+
+            THEN("The tree should be valid and ordered by the comparator")
+            {
+                CHECK(is_valid(test));
+                REQUIRE(*test.begin() == 69999);
+                REQUIRE(std::is_sorted(test.begin(), test.end(), std::greater<long long>()));
+            }
+        }
+    }
+}
@@ -0,0 +1,299 @@
+#include "catch.hpp"
+#include "../SlabAllocator.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+SCENARIO("Testing slab allocator behavior")
+{
+    GIVEN("An empty slab allocator")
+    {
+        SlabAllocator<int> alloc;
+
+        THEN("The size of allocated elements should be zero")
+        {
+            REQUIRE(alloc.size() == 0);
+        }
+
+        WHEN("A new element is allocated with default constructor")
+        {
+            int* new_elem = alloc.allocate();
+
+            THEN("The size should increase")
+            {
+                REQUIRE(alloc.size() == 1);
+            }
+
+            THEN("The new element should be value initialized")
+            {
+                REQUIRE(*new_elem == 0);
+            }
+
+            alloc.deallocate(new_elem);
+        }
+
+        WHEN("A new element is allocated with parameterized constructor")
+        {
+            int* new_elem = alloc.allocate(5);
+
+            THEN("The new element should be valid")
+            {
+                REQUIRE(*new_elem == 5);
+            }
+
+            alloc.deallocate(new_elem);
+
+            THEN("The size should decrease after deallocation")
+            {
+                REQUIRE(alloc.size() == 0);
+            }
+        }
+
+        WHEN("A null pointer is deallocated")
+        {
+            THEN("An exception should be thrown")
+            {
+                REQUIRE_THROWS_AS(alloc.deallocate(nullptr), std::invalid_argument);
+            }
+        }
+    }
+
+    GIVEN("A slab allocator with a deallocated element")
+    {
+        SlabAllocator<int> alloc;
+
+        int* fst_elem = alloc.allocate(1);
+        int* snd_elem = alloc.allocate(2);
+
+        alloc.deallocate(fst_elem);
+
+        WHEN("A new element is allocated")
+        {
+            int* trd_elem = alloc.allocate(3);
+
+            THEN("The freed slot should be reused")
+            {
+                REQUIRE(trd_elem == fst_elem);
+            }
+
+            THEN("The other elements should stay valid")
+            {
+                REQUIRE(*snd_elem == 2);
+                REQUIRE(*trd_elem == 3);
+            }
+
+            alloc.deallocate(trd_elem);
+        }
+
+        alloc.deallocate(snd_elem);
+    }
+
+    GIVEN("A slab allocator with more elements than fit in one slab")
+    {
+        SlabAllocator<std::string> alloc;
+        std::vector<std::string*> elems;
+
+        for(size_t i = 0; i < 1000; ++i)
+            elems.push_back(alloc.allocate(std::to_string(i)));
+
+        THEN("Size should be valid")
+        {
+            REQUIRE(alloc.size() == 1000);
+        }
+
+        THEN("All elements should be valid")
+        {
+            for(size_t i = 0; i < elems.size(); ++i)
+                REQUIRE(*elems[i] == std::to_string(i));
+        }
+
+        for(std::string* elem : elems)
+            alloc.deallocate(elem);
+
+        THEN("All elements should be deallocated")
+        {
+            REQUIRE(alloc.size() == 0);
+        }
+    }
+}
+
+SCENARIO("Testing tracked slab allocator")
+{
+    GIVEN("A slab allocator that tracks its elements")
+    {
+        SlabAllocator<int, Tracked> alloc;
+
+        int* fst_elem = alloc.allocate(1);
+        int* snd_elem = alloc.allocate(2);
+
+        THEN("The elements should be allocated correctly")
+        {
+            CHECK(alloc.is_allocated(fst_elem));
+            CHECK(alloc.is_allocated(snd_elem));
+        }
+
+        WHEN("An element is deallocated twice")
+        {
+            alloc.deallocate(fst_elem);
+
+            THEN("An exception should be thrown")
+            {
+                CHECK_FALSE(alloc.is_allocated(fst_elem));
+                REQUIRE_THROWS_AS(alloc.deallocate(fst_elem), std::invalid_argument);
+            }
+
+            THEN("The size should decrease only once")
+            {
+                REQUIRE(alloc.size() == 1);
+            }
+        }
+
+        alloc.deallocate(snd_elem);
+    }
+}
+
+struct DestructorCounter{
+    static size_t destroyed;
+
+    ~DestructorCounter()
+    {
+        ++destroyed;
+    }
+};
+
+size_t DestructorCounter :: destroyed = 0;
+
+SCENARIO("Testing slab allocator region release")
+{
+    GIVEN("A slab allocator with live and deallocated elements")
+    {
+        SlabAllocator<DestructorCounter> alloc;
+        std::vector<DestructorCounter*> elems;
+
+        for(size_t i = 0; i < 200; ++i)
+            elems.push_back(alloc.allocate());
+
+        for(size_t i = 0; i < elems.size(); i += 2)
+            alloc.deallocate(elems[i]);
+
+        DestructorCounter :: destroyed = 0;
+
+        WHEN("All elements are deallocated at once")
+        {
+            alloc.deallocate_all();
+
+            THEN("Only the live elements should be destroyed")
+            {
+                REQUIRE(DestructorCounter :: destroyed == 100);
+            }
+
+            THEN("The allocator should be empty")
+            {
+                REQUIRE(alloc.size() == 0);
+            }
+
+            THEN("The allocator should be usable again")
+            {
+                DestructorCounter* elem = alloc.allocate();
+                REQUIRE(alloc.size() == 1);
+                alloc.deallocate(elem);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing slab allocator reserve")
+{
+    GIVEN("A slab allocator with a partly used slab")
+    {
+        SlabAllocator<DestructorCounter> alloc;
+        std::vector<DestructorCounter*> elems;
+
+        for(size_t i = 0; i < 10; ++i)
+            elems.push_back(alloc.allocate());
+
+        WHEN("More elements than the slab can hold are reserved and allocated")
+        {
+            alloc.reserve(1000);
+
+            for(size_t i = 0; i < 1000; ++i)
+                elems.push_back(alloc.allocate());
+
+            THEN("The reserved elements should come from one block")
+            {
+                auto address = [&](size_t i){ return reinterpret_cast<std::uintptr_t>(elems[i]); };
+                std::uintptr_t step = address(11) - address(10);
+
+                for(size_t i = 10; i < 1009; ++i)
+                    REQUIRE(address(i + 1) - address(i) == step);
+            }
+
+            THEN("The next element should reuse a free slot of the old slab")
+            {
+                DestructorCounter* next = alloc.allocate();
+                std::uintptr_t step = reinterpret_cast<std::uintptr_t>(elems[1]) - reinterpret_cast<std::uintptr_t>(elems[0]);
+                std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(next) - reinterpret_cast<std::uintptr_t>(elems[0]);
+
+                REQUIRE(offset / step < 64);
+                elems.push_back(next);
+            }
+
+            THEN("Only the live elements should be destroyed by deallocate_all")
+            {
+                DestructorCounter :: destroyed = 0;
+                alloc.deallocate_all();
+
+                REQUIRE(DestructorCounter :: destroyed == 1010);
+            }
+        }
+    }
+}
+
+SCENARIO("Testing slab allocator merge")
+{
+    GIVEN("Two slab allocators with live and freed elements")
+    {
+        SlabAllocator<DestructorCounter, Tracked> alloc, other;
+        std::vector<DestructorCounter*> elems, other_elems;
+
+        for(size_t i = 0; i < 100; ++i)
+        {
+            elems.push_back(alloc.allocate());
+            other_elems.push_back(other.allocate());
+        }
+
+        for(size_t i = 0; i < 100; i += 2)
+            other.deallocate(other_elems[i]);
+
+        WHEN("The other allocator is merged into the first one")
+        {
+            alloc.merge(std::move(other));
+
+            THEN("The first allocator should own the live elements of both")
+            {
+                REQUIRE(alloc.size() == 150);
+                REQUIRE(other.size() == 0);
+
+                for(size_t i = 1; i < 100; i += 2)
+                    REQUIRE(alloc.is_allocated(other_elems[i]));
+            }
+
+            THEN("The merged allocator should keep allocating")
+            {
+                for(size_t i = 0; i < 50; ++i)
+                    alloc.allocate();
+
+                REQUIRE(alloc.size() == 200);
+            }
+
+            THEN("deallocate_all should destroy the live elements of both")
+            {
+                DestructorCounter :: destroyed = 0;
+                alloc.deallocate_all();
+
+                REQUIRE(DestructorCounter :: destroyed == 150);
+            }
+        }
+    }
+}